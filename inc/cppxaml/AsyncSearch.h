@@ -0,0 +1,191 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/** @file
+* @author Alexander Sklar
+* @section LICENSE
+ * Copyright (c) Alexander Sklar
+ *
+ * Licensed under the MIT license
+*/
+
+namespace cppxaml {
+    namespace search {
+
+        /**
+         * @brief Tells a job posted to a DebouncedExecutor whether a newer job has superseded it.
+         * @details Tokens are cheap to copy, and remain valid after the executor is destroyed (at which point they report being cancelled).
+        */
+        class CancellationToken {
+        public:
+            CancellationToken() = default;
+            CancellationToken(std::shared_ptr<const std::atomic<uint64_t>> latest, uint64_t generation) : m_latest(std::move(latest)), m_generation(generation) {}
+
+            /**
+             * @brief Whether the job should stop, and its result be discarded.
+            */
+            bool IsCancelled() const noexcept {
+                return !m_latest || m_latest->load(std::memory_order_acquire) != m_generation;
+            }
+
+            /**
+             * @brief The generation of the job the token was issued for.
+            */
+            uint64_t Generation() const noexcept { return m_generation; }
+
+        private:
+            std::shared_ptr<const std::atomic<uint64_t>> m_latest;
+            uint64_t m_generation{};
+        };
+
+        /**
+         * @brief Runs jobs on a single background thread, where only the most recently posted job matters.
+         * @details Posting a job cancels the pending one (which then never runs), and signals the running one through its CancellationToken.
+         * When a debounce interval is set, a job only starts once no other job has been posted for that long, so that a burst of keystrokes only produces one search.\n
+         * Example:\n
+         * @code
+         * cppxaml::search::DebouncedExecutor executor(std::chrono::milliseconds(100));
+         * executor.Post([index, query](const cppxaml::search::CancellationToken& token) {
+         *     auto matches = index->Find(query);
+         *     if (!token.IsCancelled()) {
+         *         // publish matches
+         *     }
+         * });
+         * @endcode
+        */
+        class DebouncedExecutor {
+        public:
+            using clock = std::chrono::steady_clock;
+            using Job = std::function<void(const CancellationToken&)>;
+
+            /**
+             * @brief Creates the executor. The background thread starts when the first job is posted.
+             * @param debounce How long to wait for the input to settle before running a job.
+            */
+            explicit DebouncedExecutor(std::chrono::milliseconds debounce = std::chrono::milliseconds(0)) : m_state(std::make_shared<State>()) {
+                m_state->debounce = debounce;
+            }
+            DebouncedExecutor(const DebouncedExecutor&) = delete;
+            DebouncedExecutor& operator=(const DebouncedExecutor&) = delete;
+
+            ~DebouncedExecutor() {
+                {
+                    std::lock_guard<std::mutex> lock(m_state->mutex);
+                    m_state->stop = true;
+                    m_state->pending = nullptr;
+                    m_state->latest.fetch_add(1, std::memory_order_acq_rel);
+                }
+                m_state->wakeup.notify_all();
+                if (m_thread.joinable()) {
+                    if (m_thread.get_id() == std::this_thread::get_id()) {
+                        // The last reference was released by a job. The thread shares ownership of the state, and exits once the job returns.
+                        m_thread.detach();
+                    }
+                    else {
+                        m_thread.join();
+                    }
+                }
+            }
+
+            /**
+             * @brief Posts a job, superseding any job that is pending or running.
+             * @param job The job to run; it gets passed a token that reports whether it has been superseded since.
+             * @return A token for the posted job, e.g. to check that a result is still current once it has been marshaled to another thread.
+            */
+            CancellationToken Post(Job job) {
+                uint64_t generation{};
+                {
+                    std::lock_guard<std::mutex> lock(m_state->mutex);
+                    generation = m_state->latest.fetch_add(1, std::memory_order_acq_rel) + 1;
+                    m_state->pending = std::move(job);
+                    m_state->lastPost = clock::now();
+                    if (!m_thread.joinable()) {
+                        m_thread = std::thread([state = m_state]() { Run(state); });
+                    }
+                }
+                m_state->wakeup.notify_all();
+                return CancellationToken(Latest(m_state), generation);
+            }
+
+            /**
+             * @brief Cancels the pending and running jobs without posting a new one.
+            */
+            void Cancel() {
+                std::lock_guard<std::mutex> lock(m_state->mutex);
+                m_state->pending = nullptr;
+                m_state->latest.fetch_add(1, std::memory_order_acq_rel);
+            }
+
+            /**
+             * @brief The debounce interval.
+            */
+            std::chrono::milliseconds Debounce() const {
+                std::lock_guard<std::mutex> lock(m_state->mutex);
+                return m_state->debounce;
+            }
+
+            /**
+             * @brief Sets the debounce interval; it applies to jobs that haven't started yet.
+            */
+            void Debounce(std::chrono::milliseconds debounce) {
+                {
+                    std::lock_guard<std::mutex> lock(m_state->mutex);
+                    m_state->debounce = debounce;
+                }
+                m_state->wakeup.notify_all();
+            }
+
+        private:
+            struct State {
+                std::mutex mutex;
+                std::condition_variable wakeup;
+                Job pending;
+                clock::time_point lastPost{};
+                std::chrono::milliseconds debounce{};
+                bool stop{ false };
+                std::atomic<uint64_t> latest{ 0 };
+            };
+
+            static std::shared_ptr<const std::atomic<uint64_t>> Latest(const std::shared_ptr<State>& state) {
+                return std::shared_ptr<const std::atomic<uint64_t>>(state, &state->latest);
+            }
+
+            static void Run(const std::shared_ptr<State>& shared) {
+                auto& state = *shared;
+                std::unique_lock<std::mutex> lock(state.mutex);
+                while (true) {
+                    state.wakeup.wait(lock, [&state]() { return state.stop || state.pending; });
+                    // every Post moves the deadline, so keep waiting until the input settles
+                    while (!state.stop && state.pending && clock::now() < state.lastPost + state.debounce) {
+                        state.wakeup.wait_until(lock, state.lastPost + state.debounce);
+                    }
+                    if (state.stop) {
+                        return;
+                    }
+                    if (!state.pending) {
+                        continue;
+                    }
+
+                    auto job = std::move(state.pending);
+                    state.pending = nullptr;
+                    // no other job can have been posted since this one, or it would have replaced it
+                    CancellationToken token(Latest(shared), state.latest.load(std::memory_order_acquire));
+                    lock.unlock();
+                    job(token);
+                    job = nullptr;
+                    lock.lock();
+                }
+            }
+
+            std::shared_ptr<State> m_state;
+            std::thread m_thread;
+        };
+    }
+}
@@ -0,0 +1,191 @@
+#pragma once
+#include <cppxaml/utils.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+/** @file
+* @author Alexander Sklar
+* @section LICENSE
+ * Copyright (c) Alexander Sklar
+ *
+ * Licensed under the MIT license
+*/
+
+namespace cppxaml {
+    namespace details {
+        /**
+         * @brief The bits of a floating point value, to encode box cache keys with. See cppxaml::details::BasicBoxCache.
+        */
+        inline uint64_t box_key_bits(double d) noexcept {
+            uint64_t bits;
+            std::memcpy(&bits, &d, sizeof(bits));
+            return bits;
+        }
+
+        /**
+         * @brief A bounded, least-recently-used cache of boxed values, so that setting the same value many times (e.g. the same `Grid.Row` on thousands of elements) reuses one box.
+         * @details Only small, immutable values are cached: arithmetic types, enums, and the structs `Traits` knows how to encode. Boxed values are immutable, so sharing them is safe.\n
+         * This doesn't depend on C++/WinRT: `Traits` supplies the boxing. cppxaml::details::BoxCache is the cache for XAML values.\n
+         * `Traits` provides:
+         * - `boxed_type`, the type of a box;
+         * - `template<typename TValue> static boxed_type Box(const TValue&)`, which boxes a value;
+         * - `template<typename TValue> static constexpr bool is_struct`, whether a struct type can be cached;
+         * - `static void Encode(const TValue&, std::array<uint64_t, 4>& bits)` for each such struct, which writes the struct's fields into the key (see cppxaml::details::box_key_bits).
+         * @tparam Traits The boxing traits.
+        */
+        template<typename Traits>
+        class BasicBoxCache {
+        public:
+            using boxed_type = typename Traits::boxed_type;
+            static constexpr size_t DefaultCapacity = 256;
+
+            /**
+             * @brief Counters, to tune the capacity.
+            */
+            struct Statistics {
+                uint64_t hits{};    // values that reused a cached box
+                uint64_t misses{};  // values that got boxed
+                uint64_t evicted{}; // boxes dropped to make room, or by lowering the capacity
+            };
+
+            template<typename TValue>
+            static constexpr bool cacheable = std::is_arithmetic_v<TValue> || std::is_enum_v<TValue> || Traits::template is_struct<TValue>;
+
+            explicit BasicBoxCache(size_t capacity = DefaultCapacity) : m_capacity(capacity) {}
+
+            /**
+             * @brief Returns the cached box for the value, boxing and caching it if it isn't cached yet.
+            */
+            template<typename TValue, std::enable_if_t<cacheable<TValue>, bool> = true>
+            boxed_type Box(const TValue& value) {
+                const auto key = MakeKey(value);
+                if (auto entry = m_index.find(key); entry != m_index.end()) {
+                    // move to the front of the list, as most recently used
+                    m_lru.splice(m_lru.begin(), m_lru, entry->second);
+                    m_stats.hits++;
+                    return entry->second->second;
+                }
+                m_stats.misses++;
+                auto boxed = Traits::Box(value);
+                if (m_capacity == 0) {
+                    return boxed;
+                }
+                if (m_index.size() >= m_capacity) {
+                    m_index.erase(m_lru.back().first);
+                    m_lru.pop_back();
+                    m_stats.evicted++;
+                }
+                m_lru.emplace_front(key, boxed);
+                m_index.emplace(key, m_lru.begin());
+                return boxed;
+            }
+
+            /**
+             * @brief Changes the capacity, dropping the least recently used boxes if there are more than that.
+            */
+            void Capacity(size_t capacity) {
+                m_capacity = capacity;
+                while (m_index.size() > m_capacity) {
+                    m_index.erase(m_lru.back().first);
+                    m_lru.pop_back();
+                    m_stats.evicted++;
+                }
+            }
+            size_t Capacity() const noexcept { return m_capacity; }
+
+            /**
+             * @brief Drops all cached boxes.
+            */
+            void Clear() {
+                m_stats.evicted += m_index.size();
+                m_index.clear();
+                m_lru.clear();
+            }
+
+            size_t size() const noexcept { return m_index.size(); }
+            const Statistics& Stats() const noexcept { return m_stats; }
+
+        private:
+            struct Key {
+                const void* type;
+                std::array<uint64_t, 4> bits;
+
+                bool operator==(const Key& other) const noexcept { return type == other.type && bits == other.bits; }
+            };
+
+            struct KeyHash {
+                size_t operator()(const Key& key) const noexcept {
+                    uint64_t hash = 14695981039346656037ull ^ reinterpret_cast<uintptr_t>(key.type);
+                    for (auto b : key.bits) {
+                        hash = (hash ^ b) * 1099511628211ull;
+                    }
+                    return static_cast<size_t>(hash);
+                }
+            };
+
+            // keys hold the value's bits, field by field, so that padding doesn't make equal values differ
+            template<typename TValue>
+            static Key MakeKey(const TValue& value) noexcept {
+                // the type is part of the key, so that equal bits of different types get different boxes
+                Key key{ &unique_tag<TValue>, {} };
+                if constexpr (std::is_floating_point_v<TValue>) {
+                    key.bits[0] = box_key_bits(static_cast<double>(value));
+                }
+                else if constexpr (std::is_arithmetic_v<TValue> || std::is_enum_v<TValue>) {
+                    std::memcpy(key.bits.data(), &value, sizeof(value));
+                }
+                else {
+                    Traits::Encode(value, key.bits);
+                }
+                return key;
+            }
+
+            using Entry = std::pair<Key, boxed_type>;
+            std::list<Entry> m_lru;
+            std::unordered_map<Key, typename std::list<Entry>::iterator, KeyHash> m_index;
+            size_t m_capacity;
+            Statistics m_stats;
+        };
+
+        /**
+         * @brief Enables a box cache on the current thread for as long as the scope exists, e.g. while building a view.
+         * @details Caching boxes is opt-in: outside of any scope, values get boxed every time. The cache belongs to the scope, so its boxes are released when the scope ends,
+         * rather than living on in thread-local storage until the thread exits (which, for COM objects, may be after the apartment is gone).
+         * Scopes nest: an inner scope's cache is used until it ends. They must end in the reverse order they started, which they do as local variables.\n
+         * cppxaml::details::BoxCacheScope is the scope for XAML values.
+         * @tparam Traits The boxing traits, see cppxaml::details::BasicBoxCache.
+        */
+        template<typename Traits>
+        class BasicBoxCacheScope {
+        public:
+            using cache_type = BasicBoxCache<Traits>;
+
+            explicit BasicBoxCacheScope(size_t capacity = cache_type::DefaultCapacity) : m_cache(capacity), m_previous(std::exchange(Slot(), &m_cache)) {}
+            ~BasicBoxCacheScope() { Slot() = m_previous; }
+            BasicBoxCacheScope(const BasicBoxCacheScope&) = delete;
+            BasicBoxCacheScope& operator=(const BasicBoxCacheScope&) = delete;
+
+            cache_type& Cache() noexcept { return m_cache; }
+
+            /**
+             * @brief The cache of the current thread's innermost scope, or `nullptr` if there is no scope.
+            */
+            static cache_type* Current() noexcept { return Slot(); }
+
+        private:
+            static cache_type*& Slot() noexcept {
+                static thread_local cache_type* current = nullptr;
+                return current;
+            }
+
+            cache_type m_cache;
+            cache_type* m_previous;
+        };
+    }
+}
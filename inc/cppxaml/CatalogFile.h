@@ -0,0 +1,370 @@
+#pragma once
+#include <cppxaml/Search.h>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+// keep windows.h from defining min/max macros and pulling in rarely used APIs in every includer
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/** @file
+* @author Alexander Sklar
+* @section LICENSE
+ * Copyright (c) Alexander Sklar
+ *
+ * Licensed under the MIT license
+*/
+
+namespace cppxaml {
+    namespace search {
+
+        /**
+         * @brief The header of a catalog file.
+         * @details A catalog file holds a Catalog and its SubstringIndex, laid out so that they can be used straight from a read-only memory mapping:
+         * | Section | Contents |
+         * | ------- | -------- |
+         * | header | CatalogFileHeader |
+         * | offsets | `count + 1` x `uint32_t`: where each item starts in the string pool, then the pool's length |
+         * | original | `textLength` x UTF-16 code unit: every item, each followed by a null terminator |
+         * | folded | same layout, with the items case-folded; only present with CatalogFileHeader::hasFolded |
+         * | suffixes | `suffixCount` x `uint32_t`: the suffix array over the folded pool (see SubstringIndex) |
+         *
+         * All values are little-endian, and every section starts at a multiple of 4 bytes (the string pools are padded).
+         * Write catalog files with cppxaml::search::WriteCatalogFile (or the `tools/BuildCatalog` tool), and load them with cppxaml::search::LoadCatalogFile.
+        */
+        struct CatalogFileHeader {
+            static constexpr uint32_t magic = 0x43535843; // "CXSC"
+            static constexpr uint16_t currentVersion = 1;
+            static constexpr uint16_t caseInsensitive = 0x1;
+            static constexpr uint16_t hasFolded = 0x2;
+
+            uint32_t signature;
+            uint16_t version;
+            uint16_t flags;
+            uint32_t count;
+            uint32_t textLength;
+            uint32_t suffixCount;
+            uint32_t reserved;
+        };
+        static_assert(sizeof(CatalogFileHeader) == 24, "CatalogFileHeader must not have padding");
+
+        namespace details {
+            constexpr size_t align4(size_t size) noexcept {
+                return (size + 3) & ~size_t(3);
+            }
+
+            /**
+             * @brief A read-only memory mapping of a whole file.
+            */
+            class MappedFile {
+            public:
+                explicit MappedFile(const std::filesystem::path& path) {
+#ifdef _WIN32
+                    auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+                    if (file == INVALID_HANDLE_VALUE) {
+                        throw std::runtime_error("Could not open catalog file");
+                    }
+                    LARGE_INTEGER size{};
+                    HANDLE mapping = nullptr;
+                    if (GetFileSizeEx(file, &size) && size.QuadPart != 0) {
+                        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                    }
+                    CloseHandle(file);
+                    if (mapping) {
+                        m_data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                        CloseHandle(mapping);
+                    }
+                    m_size = static_cast<size_t>(size.QuadPart);
+#else
+                    auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                    if (fd < 0) {
+                        throw std::runtime_error("Could not open catalog file");
+                    }
+                    struct stat info {};
+                    if (::fstat(fd, &info) == 0 && info.st_size != 0) {
+                        auto data = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                        if (data != MAP_FAILED) {
+                            m_data = data;
+                            m_size = static_cast<size_t>(info.st_size);
+                        }
+                    }
+                    ::close(fd);
+#endif
+                    if (!m_data) {
+                        throw std::runtime_error("Could not map catalog file");
+                    }
+                }
+                MappedFile(const MappedFile&) = delete;
+                MappedFile& operator=(const MappedFile&) = delete;
+
+                ~MappedFile() {
+#ifdef _WIN32
+                    UnmapViewOfFile(m_data);
+#else
+                    ::munmap(m_data, m_size);
+#endif
+                }
+
+                const uint8_t* data() const noexcept { return static_cast<const uint8_t*>(m_data); }
+                size_t size() const noexcept { return m_size; }
+
+            private:
+                void* m_data{};
+                size_t m_size{};
+            };
+
+            /**
+             * @brief Appends an item to a UTF-16 string pool. Where `wchar_t` is UTF-32, characters outside the BMP become surrogate pairs.
+            */
+            inline void append_utf16(std::u16string& pool, std::wstring_view item) {
+                for (auto c : item) {
+                    const auto cp = static_cast<uint32_t>(c);
+                    if (sizeof(wchar_t) == 4 && cp > 0xFFFF) {
+                        pool.push_back(static_cast<char16_t>(0xD800 + ((cp - 0x10000) >> 10)));
+                        pool.push_back(static_cast<char16_t>(0xDC00 + ((cp - 0x10000) & 0x3FF)));
+                    }
+                    else {
+                        pool.push_back(static_cast<char16_t>(cp));
+                    }
+                }
+            }
+
+            /**
+             * @brief Decodes UTF-8, replacing malformed sequences (including overlong encodings, surrogates and code points past U+10FFFF) with U+FFFD, one per byte.
+             * @details Characters outside the BMP become surrogate pairs where `wchar_t` is 16 bits wide. Used by `tools/BuildCatalog` to read its input.
+            */
+            inline std::wstring from_utf8(std::string_view utf8) {
+                // the smallest code point that needs each length, so that longer encodings of it are rejected
+                constexpr uint32_t minimum[] = { 0, 0, 0x80, 0x800, 0x10000 };
+                std::wstring out;
+                out.reserve(utf8.size());
+                for (size_t i = 0; i < utf8.size();) {
+                    const auto lead = static_cast<unsigned char>(utf8[i]);
+                    const size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+                    uint32_t cp = length == 1 ? lead : length == 2 ? (lead & 0x1F) : length == 3 ? (lead & 0x0F) : (lead & 0x07);
+                    bool valid = length != 0 && i + length <= utf8.size();
+                    for (size_t k = 1; valid && k < length; k++) {
+                        const auto c = static_cast<unsigned char>(utf8[i + k]);
+                        valid = (c & 0xC0) == 0x80;
+                        cp = (cp << 6) | (c & 0x3F);
+                    }
+                    if (!valid || cp < minimum[length] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+                        out.push_back(L'\xFFFD');
+                        i++;
+                        continue;
+                    }
+                    if (sizeof(wchar_t) == 2 && cp > 0xFFFF) {
+                        out.push_back(static_cast<wchar_t>(0xD800 + ((cp - 0x10000) >> 10)));
+                        out.push_back(static_cast<wchar_t>(0xDC00 + ((cp - 0x10000) & 0x3FF)));
+                    }
+                    else {
+                        out.push_back(static_cast<wchar_t>(cp));
+                    }
+                    i += length;
+                }
+                return out;
+            }
+
+            template<typename T>
+            void write_array(std::ostream& out, const T* data, size_t count) {
+                out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+                const auto padding = align4(count * sizeof(T)) - count * sizeof(T);
+                const char zeros[4]{};
+                out.write(zeros, static_cast<std::streamsize>(padding));
+            }
+        }
+
+        /**
+         * @brief Writes an index, and the catalog it indexes, in the catalog file format (see CatalogFileHeader).
+         * @param out The stream to write to; it should be opened in binary mode.
+         * @param index The index to write.
+        */
+        inline void WriteCatalogFile(std::ostream& out, const SubstringIndex& index) {
+            const auto& catalog = index.Items();
+            if (index.Segments().size() > 1) {
+                // the file holds a single suffix array
+                WriteCatalogFile(out, SubstringIndex(index.ItemsPtr()));
+                return;
+            }
+            std::u16string original;
+            original.reserve(catalog.TextLength());
+            for (id_t id = 0; id < catalog.size(); id++) {
+                details::append_utf16(original, catalog.Item(id));
+                original.push_back(u'\0');
+            }
+            if (original.size() != catalog.TextLength()) {
+                // Some characters needed surrogate pairs, so positions in the file don't match positions in memory; index the UTF-16 items instead.
+                std::vector<std::wstring> items;
+                items.reserve(catalog.size());
+                size_t start = 0;
+                for (size_t pos = 0; pos < original.size(); pos++) {
+                    if (original[pos] == u'\0') {
+                        items.emplace_back(original.begin() + start, original.begin() + pos);
+                        start = pos + 1;
+                    }
+                }
+                WriteCatalogFile(out, SubstringIndex(items, catalog.CaseInsensitive()));
+                return;
+            }
+
+            CatalogFileHeader header{};
+            header.signature = CatalogFileHeader::magic;
+            header.version = CatalogFileHeader::currentVersion;
+            header.flags = static_cast<uint16_t>((catalog.CaseInsensitive() ? CatalogFileHeader::caseInsensitive : 0) | (catalog.HasFoldedText() ? CatalogFileHeader::hasFolded : 0));
+            header.count = static_cast<uint32_t>(catalog.size());
+            header.textLength = static_cast<uint32_t>(catalog.TextLength());
+            const auto segment = index.Segments().empty() ? SubstringIndex::Segment{} : index.Segments().front();
+            header.suffixCount = static_cast<uint32_t>(segment.count);
+
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            if (catalog.size() != 0) {
+                details::write_array(out, catalog.Offsets(), catalog.size() + 1);
+            }
+            else {
+                const uint32_t offset = 0;
+                details::write_array(out, &offset, 1);
+            }
+            details::write_array(out, original.data(), original.size());
+            if (catalog.HasFoldedText()) {
+                std::u16string folded;
+                folded.reserve(original.size());
+                std::transform(original.begin(), original.end(), std::back_inserter(folded), [](char16_t c) { return static_cast<char16_t>(search::fold(c)); });
+                details::write_array(out, folded.data(), folded.size());
+            }
+            details::write_array(out, segment.suffixes, segment.count);
+            if (!out) {
+                throw std::runtime_error("Could not write catalog file");
+            }
+        }
+
+        /**
+         * @brief Writes an index, and the catalog it indexes, to a catalog file. See WriteCatalogFile(std::ostream&, const SubstringIndex&).
+        */
+        inline void WriteCatalogFile(const std::filesystem::path& path, const SubstringIndex& index) {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            WriteCatalogFile(out, index);
+        }
+
+        /**
+         * @brief Loads a catalog file by mapping it read-only into memory.
+         * @details Where `wchar_t` is 16 bits wide (i.e. on Windows), nothing gets copied: the catalog and its index point straight into the mapping,
+         * so items are only paged in as searches touch them. Elsewhere, the string pools get widened into memory, while the offsets and suffix array are still used in place.\n
+         * The layout is validated, but the order of the suffix array isn't (that would cost as much as building it), so only load files written by WriteCatalogFile.\n
+         * Example:\n
+         * @code
+         * auto asb = cppxaml::AutoSuggestBox(cppxaml::search::LoadCatalogFile(L"fonts.cxsc")).EnableDefaultSearch();
+         * @endcode
+         * @param path The file to load.
+         * @return The catalog, which can be shared by any number of `AutoSuggestBox` controls.
+        */
+        inline SuggestionCatalog LoadCatalogFile(const std::filesystem::path& path) {
+            auto file = std::make_shared<details::MappedFile>(path);
+            auto invalid = []() { return std::runtime_error("Invalid catalog file"); };
+
+            CatalogFileHeader header{};
+            if (file->size() < sizeof(header)) {
+                throw invalid();
+            }
+            std::memcpy(&header, file->data(), sizeof(header));
+            if (header.signature != CatalogFileHeader::magic || header.version != CatalogFileHeader::currentVersion) {
+                throw invalid();
+            }
+            const bool caseInsensitive = (header.flags & CatalogFileHeader::caseInsensitive) != 0;
+            const bool hasFolded = (header.flags & CatalogFileHeader::hasFolded) != 0;
+
+            const size_t offsetsAt = sizeof(header);
+            const size_t originalAt = offsetsAt + details::align4((size_t(header.count) + 1) * sizeof(uint32_t));
+            const size_t poolSize = details::align4(size_t(header.textLength) * sizeof(char16_t));
+            const size_t foldedAt = originalAt + poolSize;
+            const size_t suffixesAt = foldedAt + (hasFolded ? poolSize : 0);
+            const size_t end = suffixesAt + size_t(header.suffixCount) * sizeof(uint32_t);
+            if (end > file->size()) {
+                throw invalid();
+            }
+
+            const auto offsets = reinterpret_cast<const uint32_t*>(file->data() + offsetsAt);
+            const auto original = reinterpret_cast<const char16_t*>(file->data() + originalAt);
+            const auto foldedPool = hasFolded ? reinterpret_cast<const char16_t*>(file->data() + foldedAt) : original;
+            const auto suffixes = reinterpret_cast<const uint32_t*>(file->data() + suffixesAt);
+            if (offsets[0] != 0 || offsets[header.count] != header.textLength || header.suffixCount != header.textLength - header.count) {
+                throw invalid();
+            }
+            // matchers rely on every item being terminated
+            for (uint32_t i = 0; i < header.count; i++) {
+                if (offsets[i + 1] <= offsets[i] || original[offsets[i + 1] - 1] != u'\0' || foldedPool[offsets[i + 1] - 1] != u'\0') {
+                    throw invalid();
+                }
+            }
+            for (uint32_t i = 0; i < header.suffixCount; i++) {
+                if (suffixes[i] >= header.textLength) {
+                    throw invalid();
+                }
+            }
+
+            if constexpr (sizeof(wchar_t) == sizeof(char16_t)) {
+                const auto folded = hasFolded ? reinterpret_cast<const wchar_t*>(foldedPool) : nullptr;
+                auto catalog = std::make_shared<const Catalog>(file, reinterpret_cast<const wchar_t*>(original), folded, offsets, header.count, caseInsensitive);
+                return SuggestionCatalog(std::make_shared<const SubstringIndex>(catalog, file, suffixes, header.suffixCount));
+            }
+            else {
+                std::wstring text(original, original + header.textLength);
+                const bool hasSurrogates = std::any_of(text.begin(), text.end(), [](wchar_t c) { return c >= 0xD800 && c <= 0xDFFF; });
+                if (hasSurrogates) {
+                    // Positions differ once surrogate pairs are combined, so the mapped offsets and suffix array don't apply; rebuild them.
+                    std::vector<std::wstring> items;
+                    items.reserve(header.count);
+                    for (uint32_t i = 0; i < header.count; i++) {
+                        std::wstring item;
+                        for (auto pos = offsets[i]; pos + 1 < offsets[i + 1]; pos++) {
+                            const uint32_t c = text[pos];
+                            if (c >= 0xD800 && c <= 0xDBFF && pos + 2 < offsets[i + 1] && text[pos + 1] >= 0xDC00 && text[pos + 1] <= 0xDFFF) {
+                                item.push_back(static_cast<wchar_t>(0x10000 + ((c - 0xD800) << 10) + (text[pos + 1] - 0xDC00)));
+                                pos++;
+                            }
+                            else {
+                                item.push_back(static_cast<wchar_t>(c));
+                            }
+                        }
+                        items.push_back(std::move(item));
+                    }
+                    return SuggestionCatalog(items, caseInsensitive);
+                }
+
+                struct Storage {
+                    std::shared_ptr<details::MappedFile> file;
+                    std::wstring original;
+                    std::wstring folded;
+                };
+                auto storage = std::make_shared<Storage>();
+                storage->file = file;
+                storage->original = std::move(text);
+                if (hasFolded) {
+                    storage->folded.assign(foldedPool, foldedPool + header.textLength);
+                }
+                const auto folded = hasFolded ? storage->folded.data() : nullptr;
+                auto catalog = std::make_shared<const Catalog>(storage, storage->original.data(), folded, offsets, header.count, caseInsensitive);
+                return SuggestionCatalog(std::make_shared<const SubstringIndex>(catalog, storage, suffixes, header.suffixCount));
+            }
+        }
+    }
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include <cppxaml/utils.h>
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/** @file
+* @author Alexander Sklar
+* @section LICENSE
+ * Copyright (c) Alexander Sklar
+ *
+ * Licensed under the MIT license
+*/
+
+namespace cppxaml {
+    namespace details {
+        /**
+         * @brief Counts the calls across the ABI that the panel, grid and items control builders make on the current thread, to measure what batching saves.
+         * @details Every call that cppxaml::details::CollectionBuilder makes through its traits counts as one crossing: activations, property setters, `QueryInterface` calls,
+         * and collection getters and updates. Calls made by the children themselves aren't counted.
+        */
+        struct BuilderStatistics {
+            uint64_t added{};     // children, row/column definitions and items added
+            uint64_t crossings{}; // calls across the ABI made to add them
+        };
+
+        inline BuilderStatistics& BuilderStats() noexcept {
+            static thread_local BuilderStatistics stats;
+            return stats;
+        }
+
+        /**
+         * @brief Fills the collections of panels, grids and items controls. The items are collected first, and each collection gets them with a single `ReplaceAll` call, rather than one `Append` call per item.
+         * @details The builder reaches XAML only through `Traits`, whose functions are each one call across the ABI; it counts them in cppxaml::details::BuilderStats() as it makes them.\n
+         * `Traits` must provide:
+         * - `element_t`: a child element; `placed_t`: a child along with the cell it goes in (`m_element`, `m_row` and `m_column`);
+         * - `item_t`: an item of an items control, and `static item_t box(const T&)` for the values that aren't one already;
+         * - `static auto children(const TPanel&)`, `row_definitions(const TGrid&)`, `column_definitions(const TGrid&)` and `items(const TItemsControl&)`: get a collection;
+         * - `static void replace_all(TCollection&, const T* first, const T* last)`: replaces the contents of a collection;
+         * - `static auto create_row_definition()` and `create_column_definition()`; `static void set_height(TRowDefinition&, const TLength&)` and `set_width(TColumnDefinition&, const TLength&)`;
+         * - `static auto as_framework_element(const element_t&)`, and `static void set_row(const TFrameworkElement&, int)` and `set_column(const TFrameworkElement&, int)`.
+         *
+         * Controls.h provides the XAML traits, which cppxaml::MakePanel, cppxaml::Grid and cppxaml::MakeItemsControl use.
+        */
+        template<typename Traits>
+        struct CollectionBuilder {
+            using element_t = typename Traits::element_t;
+            using placed_t = typename Traits::placed_t;
+            using item_t = typename Traits::item_t;
+
+            /**
+             * @brief Sets the children of a panel, without copying them.
+            */
+            template<typename TPanel>
+            static void AddChildren(const TPanel& panel, std::initializer_list<element_t> elems) {
+                if (elems.size() != 0) {
+                    auto children = Cross([&] { return Traits::children(panel); });
+                    Cross([&] { Traits::replace_all(children, elems.begin(), elems.end()); });
+                    BuilderStats().added += elems.size();
+                }
+            }
+
+            /**
+             * @brief Sets the children of a panel from a range, which can be a lazy view such as cppxaml::utils::transform_view.
+            */
+            template<typename TPanel, typename TElements>
+            static void AddChildren(const TPanel& panel, TElements&& elems) {
+                std::vector<element_t> children;
+                reserve_for(children, elems);
+                // auto&& so that views whose iterators yield values work too
+                for (auto&& e : elems) {
+                    children.push_back(e);
+                }
+                ReplaceAll([&] { return Traits::children(panel); }, children);
+            }
+
+            /**
+             * @brief Sets the row and column definitions of a grid, and its children, which are either `placed_t` or `element_t` (which go in the first cell).
+            */
+            template<typename TGrid, typename TRows, typename TColumns, typename TElements>
+            static void AddGridContents(const TGrid& grid, const TRows& rows, const TColumns& columns, TElements&& elems) {
+                std::vector<decltype(Traits::create_row_definition())> rowDefinitions;
+                reserve_for(rowDefinitions, rows);
+                for (auto& r : rows) {
+                    auto& rd = rowDefinitions.emplace_back(Cross([] { return Traits::create_row_definition(); }));
+                    Cross([&] { Traits::set_height(rd, r); });
+                }
+                ReplaceAll([&] { return Traits::row_definitions(grid); }, rowDefinitions);
+
+                std::vector<decltype(Traits::create_column_definition())> columnDefinitions;
+                reserve_for(columnDefinitions, columns);
+                for (auto& c : columns) {
+                    auto& cd = columnDefinitions.emplace_back(Cross([] { return Traits::create_column_definition(); }));
+                    Cross([&] { Traits::set_width(cd, c); });
+                }
+                ReplaceAll([&] { return Traits::column_definitions(grid); }, columnDefinitions);
+
+                std::vector<element_t> children;
+                reserve_for(children, elems);
+                for (auto&& e : elems) {
+                    if constexpr (std::is_assignable_v<placed_t&, decltype(e)>) {
+                        const auto fe = Cross([&] { return Traits::as_framework_element(e.m_element); });
+                        Cross([&] { Traits::set_row(fe, e.m_row); });
+                        Cross([&] { Traits::set_column(fe, e.m_column); });
+                        children.push_back(e.m_element);
+                    }
+                    else {
+                        children.push_back(e);
+                    }
+                }
+                ReplaceAll([&] { return Traits::children(grid); }, children);
+            }
+
+            /**
+             * @brief Sets the items of an items control, boxing the ones that aren't `item_t` already.
+            */
+            template<typename TItemsControl, typename TItems>
+            static void AddItems(const TItemsControl& control, const TItems& items) {
+                std::vector<item_t> boxed;
+                reserve_for(boxed, items);
+                for (auto&& i : items) {
+                    if constexpr (std::is_assignable_v<item_t&, decltype(i)>) {
+                        boxed.push_back(i);
+                    }
+                    else {
+                        boxed.push_back(Cross([&] { return Traits::box(i); }));
+                    }
+                }
+                ReplaceAll([&] { return Traits::items(control); }, boxed);
+            }
+
+        private:
+            // makes one call across the ABI, and counts it
+            template<typename Call>
+            static decltype(auto) Cross(Call&& call) {
+                BuilderStats().crossings++;
+                return std::forward<Call>(call)();
+            }
+
+            template<typename GetCollection, typename T>
+            static void ReplaceAll(GetCollection&& getCollection, const std::vector<T>& values) {
+                if (!values.empty()) {
+                    auto collection = Cross(std::forward<GetCollection>(getCollection));
+                    Cross([&] { Traits::replace_all(collection, values.data(), values.data() + values.size()); });
+                    BuilderStats().added += values.size();
+                }
+            }
+        };
+    }
+}
@@ -8,11 +8,27 @@
 #include <winrt/Windows.Foundation.Collections.h>
 #include <winrt/Windows.Foundation.h>
 #include <type_traits>
+#include <numeric>
+#include <array>
+#include <functional>
+#include <memory>
+#include <unordered_map>
 
 #include <cppxaml/utils.h>
+#include <cppxaml/BoxCache.h>
+#include <cppxaml/CollectionBuilder.h>
+#include <cppxaml/Search.h>
+#include <cppxaml/AsyncSearch.h>
+#include <cppxaml/SearchHandler.h>
+#include <cppxaml/Layout.h>
+#include <cppxaml/ElementTemplate.h>
+#include <cppxaml/RecyclePool.h>
 #include <cppxaml/VisualState.h>
 #ifdef USE_WINUI3
 #include <microsoft.ui.xaml.window.h>
+#include <winrt/Microsoft.UI.Dispatching.h>
+#else
+#include <winrt/Windows.UI.Core.h>
 #endif
 
 /** @file
@@ -30,7 +46,223 @@
 */
 namespace cppxaml {
 
+    /**
+     * @brief Options for the default search experience of an `AutoSuggestBox`. See cppxaml::details::Wrapper<cppxaml::xaml::Controls::AutoSuggestBox, TItems>::EnableDefaultSearch.
+    */
+    struct SearchOptions {
+        /**
+         * @brief Whether the search should be case insensitive or not.
+        */
+        bool caseInsensitive{ true };
+        /**
+         * @brief Whether to reuse the matches of the previous query when the new query contains it (e.g. as the user keeps typing), instead of searching every item again.
+        */
+        bool incremental{ false };
+        /**
+         * @brief Whether to search on a background thread instead of the UI thread. Queries that are superseded by a newer keystroke get cancelled, and only the final result is marshaled back to update the `ItemsSource`.
+        */
+        bool async{ false };
+        /**
+         * @brief When searching asynchronously, how long the user has to stop typing before a search starts.
+        */
+        std::chrono::milliseconds debounce{ 0 };
+        /**
+         * @brief Whether to hand the `AutoSuggestBox` a read-only vector over the matches, which only boxes the items the list actually asks for (usually the ten or so that are visible), 
+         * instead of boxing every match into a new vector on each keystroke.
+        */
+        bool virtualize{ false };
+        /**
+         * @brief Whether to keep showing the same `ItemsSource` as the user types, and only raise the insertions and removals needed to turn the previous suggestions into the new ones
+         * (see cppxaml::search::Diff), so that the list keeps the containers of suggestions that remain instead of rebuilding all of them. Implies SearchOptions::virtualize.
+        */
+        bool minimalUpdates{ false };
+        /**
+         * @brief Whether to rank the suggestions by how well they match (see cppxaml::search::Score), which also brings in fuzzy matches, e.g. "tnr" for "Times New Roman".
+         * @details Only the best SearchOptions::maxResults suggestions are shown.
+        */
+        bool ranked{ false };
+        /**
+         * @brief The maximum number of suggestions to show when SearchOptions::ranked is set, or 0 for no limit.
+        */
+        size_t maxResults{ 20 };
+        /**
+         * @brief When SearchOptions::ranked is set, the maximum number of items scored as fuzzy matches on each keystroke (see cppxaml::search::SubstringIndex::FuzzyCandidates).
+        */
+        size_t fuzzyBudget{ cppxaml::search::SubstringIndex::DefaultFuzzyBudget };
+    };
+
     namespace details {
+        /**
+         * @brief Base of the typed attached property tags, like cppxaml::Row: holds the value, and is set through the tag's static `Apply` instead of a boxed `SetValue`.
+        */
+        template<typename Tag>
+        struct AttachedProperty {
+            int32_t value;
+            constexpr explicit AttachedProperty(int32_t v) noexcept : value(v) {}
+        };
+
+        template<typename TTag, typename = void>
+        struct is_attached_property : std::false_type {};
+        template<typename TTag>
+        struct is_attached_property<TTag, std::void_t<decltype(TTag::Apply(std::declval<const cppxaml::xaml::FrameworkElement&>(), std::declval<const TTag&>().value))>>
+            : std::is_base_of<AttachedProperty<TTag>, TTag> {};
+    }
+
+    /**
+     * @brief Sets `Grid.Row` with `Grid::SetRow`, without boxing the value or looking up the property: `cppxaml::TextBlock(L"x").Set(cppxaml::Row(1))`.
+    */
+    struct Row : details::AttachedProperty<Row> {
+        using AttachedProperty::AttachedProperty;
+        static void Apply(const cppxaml::xaml::FrameworkElement& e, int32_t v) { cppxaml::xaml::Controls::Grid::SetRow(e, v); }
+    };
+    /**
+     * @brief Sets `Grid.Column` with `Grid::SetColumn`. See cppxaml::Row.
+    */
+    struct Column : details::AttachedProperty<Column> {
+        using AttachedProperty::AttachedProperty;
+        static void Apply(const cppxaml::xaml::FrameworkElement& e, int32_t v) { cppxaml::xaml::Controls::Grid::SetColumn(e, v); }
+    };
+    /**
+     * @brief Sets `Grid.RowSpan` with `Grid::SetRowSpan`. See cppxaml::Row.
+    */
+    struct RowSpan : details::AttachedProperty<RowSpan> {
+        using AttachedProperty::AttachedProperty;
+        static void Apply(const cppxaml::xaml::FrameworkElement& e, int32_t v) { cppxaml::xaml::Controls::Grid::SetRowSpan(e, v); }
+    };
+    /**
+     * @brief Sets `Grid.ColumnSpan` with `Grid::SetColumnSpan`. See cppxaml::Row.
+    */
+    struct ColumnSpan : details::AttachedProperty<ColumnSpan> {
+        using AttachedProperty::AttachedProperty;
+        static void Apply(const cppxaml::xaml::FrameworkElement& e, int32_t v) { cppxaml::xaml::Controls::Grid::SetColumnSpan(e, v); }
+    };
+
+    namespace details {
+        /**
+         * @brief Counts property setter calls made by cppxaml wrappers on the current thread, to measure what deferred setters save (see cppxaml::details::WrapperT::Defer).
+        */
+        struct SetterStatistics {
+            uint64_t invoked{};   // setters called on XAML objects
+            uint64_t recorded{};  // setters recorded by deferred wrappers
+            uint64_t coalesced{}; // recorded setters that replaced an earlier write to the same property
+        };
+
+        inline SetterStatistics& SetterStats() noexcept {
+            static thread_local SetterStatistics stats;
+            return stats;
+        }
+
+        /**
+         * @brief The command buffer of a deferred wrapper: one pending write per property, applied in the order the properties were first written.
+        */
+        template<typename T>
+        class SetterBuffer {
+        public:
+            using Setter = std::function<void(const T&)>;
+
+            bool Active() const noexcept { return m_active; }
+
+            /**
+             * @brief Records a write, replacing the pending write to the same property if any.
+             * @param key Identifies the property.
+            */
+            void Record(const void* key, Setter setter) {
+                auto& stats = SetterStats();
+                stats.recorded++;
+                for (auto& command : m_commands) {
+                    if (command.first == key) {
+                        command.second = std::move(setter);
+                        stats.coalesced++;
+                        return;
+                    }
+                }
+                m_commands.emplace_back(key, std::move(setter));
+            }
+
+            /**
+             * @brief Applies the pending writes, and stops deferring.
+            */
+            void Commit(const T& target) {
+                m_active = false;
+                auto commands = std::move(m_commands);
+                m_commands.clear();
+                for (auto& command : commands) {
+                    command.second(target);
+                }
+                SetterStats().invoked += commands.size();
+            }
+
+        private:
+            std::vector<std::pair<const void*, Setter>> m_commands;
+            bool m_active{ true };
+        };
+
+        /**
+         * @brief Boxes XAML values for cppxaml::details::BoxCache, which also caches `Thickness`, `CornerRadius` and `GridLength`.
+        */
+        struct XamlBoxTraits {
+            using boxed_type = winrt::Windows::Foundation::IInspectable;
+
+            template<typename TValue>
+            static constexpr bool is_struct = std::is_same_v<TValue, cppxaml::xaml::Thickness> || std::is_same_v<TValue, cppxaml::xaml::CornerRadius> || std::is_same_v<TValue, cppxaml::xaml::GridLength>;
+
+            template<typename TValue>
+            static boxed_type Box(const TValue& value) {
+                return winrt::box_value(value);
+            }
+
+            static void Encode(const cppxaml::xaml::Thickness& value, std::array<uint64_t, 4>& bits) noexcept {
+                bits = { box_key_bits(value.Left), box_key_bits(value.Top), box_key_bits(value.Right), box_key_bits(value.Bottom) };
+            }
+
+            static void Encode(const cppxaml::xaml::CornerRadius& value, std::array<uint64_t, 4>& bits) noexcept {
+                bits = { box_key_bits(value.TopLeft), box_key_bits(value.TopRight), box_key_bits(value.BottomRight), box_key_bits(value.BottomLeft) };
+            }
+
+            static void Encode(const cppxaml::xaml::GridLength& value, std::array<uint64_t, 4>& bits) noexcept {
+                bits = { box_key_bits(value.Value), static_cast<uint64_t>(value.GridUnitType) };
+            }
+        };
+
+        /**
+         * @brief The cache of boxed XAML values: arithmetic types, enums, `Thickness`, `CornerRadius` and `GridLength`. See cppxaml::details::BasicBoxCache.
+        */
+        using BoxCache = BasicBoxCache<XamlBoxTraits>;
+
+        /**
+         * @brief Makes cppxaml::details::WrapperT::Set reuse boxes for small immutable values on the current thread while it exists. See cppxaml::details::BasicBoxCacheScope.
+         * @details Example:\n
+         * @code
+         * {
+         *     cppxaml::details::BoxCacheScope boxes;
+         *     auto grid = BuildDashboard(); // thousands of Set(Grid::RowProperty(), ...) calls share a few boxes
+         * } // the cached boxes are released here
+         * @endcode
+        */
+        using BoxCacheScope = BasicBoxCacheScope<XamlBoxTraits>;
+
+        /**
+         * @brief Boxes a value, reusing a cached box for small immutable values when a cppxaml::details::BoxCacheScope is active.
+        */
+        template<typename TValue>
+        winrt::Windows::Foundation::IInspectable BoxValue(const TValue& value) {
+            if constexpr (BoxCache::cacheable<TValue>) {
+                if (auto cache = BoxCacheScope::Current()) {
+                    return cache->Box(value);
+                }
+            }
+            return winrt::box_value(value);
+        }
+
+        // tag types for the properties WrapperT has dedicated setters for; the keys are their unique_tag addresses
+        namespace setter_keys {
+            struct name;
+            struct margin;
+            struct padding;
+            template<typename TTag>
+            struct tag;
+        }
+
         /**
          * @brief Internal wrapper type that powers builder-style programming. \n
          * This type is usually constructed and destructed in a single declaration line, only serving to set properties on the underlying XAML element, or to add the element to a parent.
@@ -43,39 +275,81 @@ namespace cppxaml {
             WrapperT(const T& v = T()) : m_value(v) {}
 
             T operator*() const {
+                Commit();
                 return m_value;
             }
-            const T* operator->() const { return &m_value; }
+            const T* operator->() const { Commit(); return &m_value; }
+
+            /**
+             * @brief Starts recording the setters called through this wrapper (and its copies) instead of calling them on the element, e.g. while building a subtree that isn't in the live tree yet.
+             * @details Writes to the same property are coalesced, so only the last one gets applied.
+             * The recorded setters are applied in one pass, and deferring stops, when Commit is called, or the element is taken out of the wrapper (e.g. to add it to a parent).\n
+             * Values are copied when recorded; boxing them is deferred too. See cppxaml::details::SetterStats for counts of recorded and applied setters.\n
+             * Example:\n
+             * @code
+             * auto button = cppxaml::Button(L"OK").Defer().Margin(4).Margin(8).Set(Controls::Grid::ColumnProperty(), 1);
+             * grid->Children().Append(button); // a single Margin write, and the Grid.Column write, happen here
+             * @endcode
+            */
+            auto Defer() const {
+                auto copy = *this;
+                if (!copy.m_deferred || !copy.m_deferred->Active()) {
+                    copy.m_deferred = std::make_shared<SetterBuffer<T>>();
+                }
+                return copy;
+            }
+
+            /**
+             * @brief Applies the setters recorded since Defer was called, and stops deferring.
+            */
+            auto Commit() const {
+                if (m_deferred && m_deferred->Active()) {
+                    m_deferred->Commit(m_value);
+                }
+                return *this;
+            }
 
             /**
              * @brief Returns the element's Name
              * @return
             */
-            auto Name() const { return m_value.Name(); }
+            auto Name() const { Commit(); return m_value.Name(); }
             /**
              * @brief Set the element's Name
              * @param n
              * @return
             */
-            auto Name(std::wstring_view n) const { m_value.Name(n); return *this; }
+            auto Name(std::wstring_view n) const {
+                if (Deferring()) {
+                    m_deferred->Record(&unique_tag<setter_keys::name>, [n = winrt::hstring(n)](const T& v) { v.Name(n); });
+                }
+                else {
+                    m_value.Name(n);
+                    SetterStats().invoked++;
+                }
+                return *this;
+            }
 
             /**
              * @brief
              * @return
             */
-            auto Margin() const { return m_value.Margin(); }
+            auto Margin() const { Commit(); return m_value.Margin(); }
             /**
              * @brief
              * @param t `Thickness` struct
              * @return
             */
-            auto Margin(cppxaml::xaml::Thickness t) const { m_value.Margin(t); return *this; }
+            auto Margin(cppxaml::xaml::Thickness t) const {
+                Apply(&unique_tag<setter_keys::margin>, [t](const T& v) { v.Margin(t); });
+                return *this;
+            }
             /**
              * @brief
              * @param m Uniform length
              * @return
             */
-            auto Margin(double m) const { m_value.Margin(cppxaml::xaml::ThicknessHelper::FromUniformLength(m)); return *this; }
+            auto Margin(double m) const { return Margin(cppxaml::xaml::Thickness{ m, m, m, m }); }
             /**
              * @brief
              * @param left
@@ -85,26 +359,29 @@ namespace cppxaml {
              * @return
             */
             auto Margin(double left, double top, double right, double bottom) const {
-                m_value.Margin(cppxaml::xaml::ThicknessHelper::FromLengths(left, top, right, bottom)); return *this;
+                return Margin(cppxaml::xaml::Thickness{ left, top, right, bottom });
             }
 
             /**
              * @brief
              * @return
             */
-            auto Padding() const { return m_value.Padding(); }
+            auto Padding() const { Commit(); return m_value.Padding(); }
             /**
              * @brief
              * @param t `Thickness` struct
              * @return
             */
-            auto Padding(cppxaml::xaml::Thickness t) const { m_value.Padding(t); return *this; }
+            auto Padding(cppxaml::xaml::Thickness t) const {
+                Apply(&unique_tag<setter_keys::padding>, [t](const T& v) { v.Padding(t); });
+                return *this;
+            }
             /**
              * @brief
              * @param m Uniform length
              * @return
             */
-            auto Padding(double m) const { m_value.Padding(cppxaml::xaml::ThicknessHelper::FromUniformLength(m)); return *this; }
+            auto Padding(double m) const { return Padding(cppxaml::xaml::Thickness{ m, m, m, m }); }
             /**
              * @brief
              * @param left
@@ -114,11 +391,12 @@ namespace cppxaml {
              * @return
             */
             auto Padding(double left, double top, double right, double bottom) const {
-                m_value.Padding(cppxaml::xaml::ThicknessHelper::FromLengths(left, top, right, bottom)); return *this;
+                return Padding(cppxaml::xaml::Thickness{ left, top, right, bottom });
             }
 
             template<typename D, std::enable_if_t<std::is_assignable_v<D, T>, bool> = true>
             operator D() const {
+                Commit();
                 return m_value;
             }
 
@@ -137,17 +415,43 @@ namespace cppxaml {
             */
             template<typename TValue>
             auto Set(cppxaml::xaml::DependencyProperty dp, TValue&& value) {
-                if constexpr (std::is_assignable_v<winrt::Windows::Foundation::IInspectable, TValue>) {
-                    m_value.SetValue(dp, std::move(value));
-                }
-                else {
-                    m_value.SetValue(dp, winrt::box_value(std::move(value)));
-                }
+                // strings get copied, since a deferred setter can outlive the caller's buffer
+                using stored_t = std::conditional_t<std::is_convertible_v<std::decay_t<TValue>, std::wstring_view>, winrt::hstring, std::decay_t<TValue>>;
+                const void* key = winrt::get_abi(dp);
+                Apply(key, [dp, value = stored_t(std::forward<TValue>(value))](const T& v) {
+                    if constexpr (std::is_assignable_v<winrt::Windows::Foundation::IInspectable, stored_t>) {
+                        v.SetValue(dp, value);
+                    }
+                    else {
+                        v.SetValue(dp, BoxValue(value));
+                    }
+                });
+                return *this;
+            }
+
+            /**
+             * @brief Sets a well-known attached property through its typed setter, e.g. `Grid::SetRow`, which neither boxes the value nor calls the property's getter.
+             * @tparam TTag A tag type: cppxaml::Row, cppxaml::Column, cppxaml::RowSpan or cppxaml::ColumnSpan.
+             * @param tag The tag, holding the value.
+             * @return
+             * @details Example:\n
+             * @code
+             * auto buttonInGrid = cppxaml::Button(L"Click me")
+             *                          .Set(cppxaml::Row(3))
+             *                          .Set(cppxaml::ColumnSpan(2));
+             * @endcode
+             * When deferring (see Defer), writes through a tag coalesce with other writes through the same tag, but not with `Set(dp, value)` writes to the same property.
+            */
+            template<typename TTag, std::enable_if_t<is_attached_property<TTag>::value, bool> = true>
+            auto Set(TTag tag) const {
+                static_assert(std::is_convertible_v<T, cppxaml::xaml::FrameworkElement>, "Attached property tags can only be set on a FrameworkElement");
+                Apply(&unique_tag<setter_keys::tag<TTag>>, [value = tag.value](const T& v) { TTag::Apply(v, value); });
                 return *this;
             }
 
             /**
              * @brief Sets up a visual state change listeners
+             * @tparam TMap The map's type; see cppxaml::VSMListener.
              * @param map A map of visual state names to handlers
              * @return 
              * @details Example:\n
@@ -167,9 +471,26 @@ namespace cppxaml {
              * @endcode
              * @image html VSM.gif
             */
-            auto VisualStates(const std::unordered_map<std::wstring, cppxaml::xaml::VisualStateChangedEventHandler>& map) {
+            template<typename TMap = std::unordered_map<std::wstring, cppxaml::xaml::VisualStateChangedEventHandler>>
+            auto VisualStates(const TMap& map) {
                 return cppxaml::VSMListener(*this, map);
             }
+
+        private:
+            std::shared_ptr<SetterBuffer<T>> m_deferred;
+
+            bool Deferring() const noexcept { return m_deferred && m_deferred->Active(); }
+
+            template<typename F>
+            void Apply(const void* key, F&& setter) const {
+                if (Deferring()) {
+                    m_deferred->Record(key, std::forward<F>(setter));
+                }
+                else {
+                    setter(m_value);
+                    SetterStats().invoked++;
+                }
+            }
         };
 
         using VisualStateMap = std::unordered_map<std::wstring, cppxaml::xaml::VisualStateChangedEventHandler>;
@@ -200,91 +521,498 @@ namespace cppxaml {
         };
 
         /**
-         * @brief builder-style wrapper for `AutoSuggestBox`
-         * @tparam TItems the type of collection from which to initialize the `AutoSuggestBox`'s `Items`.
+         * @brief Arguments of the `VectorChanged` event of SuggestionsVector.
+        */
+        struct VectorChangedArgs : winrt::implements<VectorChangedArgs, winrt::Windows::Foundation::Collections::IVectorChangedEventArgs> {
+            VectorChangedArgs(winrt::Windows::Foundation::Collections::CollectionChange change, uint32_t index) : m_change(change), m_index(index) {}
+            winrt::Windows::Foundation::Collections::CollectionChange CollectionChange() const noexcept { return m_change; }
+            uint32_t Index() const noexcept { return m_index; }
+        private:
+            winrt::Windows::Foundation::Collections::CollectionChange m_change;
+            uint32_t m_index;
+        };
+
+        /**
+         * @brief A read-only `IObservableVector` over the matches of a search, which boxes items lazily.
+         * @details `Size` is known without materializing anything, and an item only gets boxed the first time it is requested (e.g. by `GetAt` as the list realizes a visible row). 
+         * Boxed items are kept so that the list sees the same object if it asks for an item again.\n
+         * The vector can't be modified through `IVector`, but SuggestionsVector::Update replaces its contents and raises `VectorChanged` accordingly.
+        */
+        struct SuggestionsVector : winrt::implements<SuggestionsVector,
+            winrt::Windows::Foundation::Collections::IObservableVector<winrt::Windows::Foundation::IInspectable>,
+            winrt::Windows::Foundation::Collections::IVector<winrt::Windows::Foundation::IInspectable>,
+            winrt::Windows::Foundation::Collections::IVectorView<winrt::Windows::Foundation::IInspectable>,
+            winrt::Windows::Foundation::Collections::IIterable<winrt::Windows::Foundation::IInspectable>> {
+            using IInspectable = winrt::Windows::Foundation::IInspectable;
+
+            SuggestionsVector(std::shared_ptr<const cppxaml::search::SubstringIndex> index, std::vector<cppxaml::search::id_t> matches) :
+                m_index(std::move(index)), m_matches(std::move(matches)), m_all(false) {}
+
+            /**
+             * @brief Creates a vector over every item in the index, without allocating a table of ids.
+            */
+            SuggestionsVector(std::shared_ptr<const cppxaml::search::SubstringIndex> index) : m_index(std::move(index)), m_all(true) {}
+
+            uint32_t Size() const noexcept { return static_cast<uint32_t>(m_all ? m_index->size() : m_matches.size()); }
+
+            /**
+             * @brief The index the matches refer to.
+            */
+            const std::shared_ptr<const cppxaml::search::SubstringIndex>& Index() const noexcept { return m_index; }
+
+            /**
+             * @brief Replaces the matches, raising `ItemRemoved` and `ItemInserted` for the edits between the current and new matches (see cppxaml::search::Diff).
+             * @details When there are more edits than it would take to rebuild the list, a single `Reset` is raised instead.
+             * Must be called on the UI thread.
+             * @param matches The new matches.
+             * @param index The index the new matches refer to: either the current one, or a newer snapshot of the same StreamingCatalog.
+            */
+            void Update(std::vector<cppxaml::search::id_t> matches, std::shared_ptr<const cppxaml::search::SubstringIndex> index) {
+                // ids are stable across snapshots of a StreamingCatalog, so the current matches still refer to the same items
+                m_index = std::move(index);
+                if (m_all) {
+                    m_matches.resize(m_index->size());
+                    std::iota(m_matches.begin(), m_matches.end(), cppxaml::search::id_t{ 0 });
+                    m_all = false;
+                }
+                const auto edits = cppxaml::search::Diff(m_matches, matches);
+                if (edits.empty()) {
+                    return;
+                }
+                // every edit shifts the tail of the list, both here and in the list's containers
+                if (edits.size() > maxEdits || edits.size() > matches.size()) {
+                    m_matches = std::move(matches);
+                    m_boxed.clear();
+                    m_vectorChanged(*this, winrt::make<VectorChangedArgs>(winrt::Windows::Foundation::Collections::CollectionChange::Reset, 0));
+                    return;
+                }
+                for (const auto& edit : edits) {
+                    if (edit.kind == cppxaml::search::Edit::Kind::Remove) {
+                        m_matches.erase(m_matches.begin() + edit.index);
+                        m_boxed.erase(edit.id);
+                        m_vectorChanged(*this, winrt::make<VectorChangedArgs>(winrt::Windows::Foundation::Collections::CollectionChange::ItemRemoved, edit.index));
+                    }
+                    else {
+                        m_matches.insert(m_matches.begin() + edit.index, edit.id);
+                        m_vectorChanged(*this, winrt::make<VectorChangedArgs>(winrt::Windows::Foundation::Collections::CollectionChange::ItemInserted, edit.index));
+                    }
+                }
+            }
+
+            IInspectable GetAt(uint32_t index) const {
+                if (index >= Size()) {
+                    throw winrt::hresult_out_of_bounds();
+                }
+                return Box(IdAt(index));
+            }
+
+            uint32_t GetMany(uint32_t startIndex, winrt::array_view<IInspectable> items) const {
+                uint32_t count = 0;
+                for (; count < items.size() && startIndex + count < Size(); count++) {
+                    items[count] = Box(IdAt(startIndex + count));
+                }
+                return count;
+            }
+
+            bool IndexOf(IInspectable const& value, uint32_t& index) const {
+                for (const auto& [id, boxed] : m_boxed) {
+                    if (boxed == value) {
+                        index = PositionOf(id);
+                        return true;
+                    }
+                }
+                if (auto str = value.try_as<winrt::Windows::Foundation::IReference<winrt::hstring>>()) {
+                    const auto text = str.Value();
+                    const auto& catalog = m_index->Items();
+                    for (uint32_t i = 0; i < Size(); i++) {
+                        if (catalog.Item(IdAt(i)) == text) {
+                            index = i;
+                            return true;
+                        }
+                    }
+                }
+                return false;
+            }
+
+            winrt::Windows::Foundation::Collections::IVectorView<IInspectable> GetView() {
+                return *this;
+            }
+
+            winrt::Windows::Foundation::Collections::IIterator<IInspectable> First() {
+                return winrt::make<Iterator>(get_strong());
+            }
+
+            winrt::event_token VectorChanged(winrt::Windows::Foundation::Collections::VectorChangedEventHandler<IInspectable> const& handler) {
+                return m_vectorChanged.add(handler);
+            }
+            void VectorChanged(winrt::event_token const& token) noexcept {
+                m_vectorChanged.remove(token);
+            }
+
+            void SetAt(uint32_t, IInspectable const&) { throw winrt::hresult_illegal_method_call(); }
+            void InsertAt(uint32_t, IInspectable const&) { throw winrt::hresult_illegal_method_call(); }
+            void RemoveAt(uint32_t) { throw winrt::hresult_illegal_method_call(); }
+            void Append(IInspectable const&) { throw winrt::hresult_illegal_method_call(); }
+            void RemoveAtEnd() { throw winrt::hresult_illegal_method_call(); }
+            void Clear() { throw winrt::hresult_illegal_method_call(); }
+            void ReplaceAll(winrt::array_view<IInspectable const>) { throw winrt::hresult_illegal_method_call(); }
+
+        private:
+            struct Iterator : winrt::implements<Iterator, winrt::Windows::Foundation::Collections::IIterator<IInspectable>> {
+                Iterator(winrt::com_ptr<SuggestionsVector> owner) : m_owner(std::move(owner)) {}
+                IInspectable Current() const { return m_owner->GetAt(m_current); }
+                bool HasCurrent() const noexcept { return m_current < m_owner->Size(); }
+                bool MoveNext() noexcept {
+                    if (m_current < m_owner->Size()) {
+                        m_current++;
+                    }
+                    return HasCurrent();
+                }
+                uint32_t GetMany(winrt::array_view<IInspectable> items) {
+                    auto count = m_owner->GetMany(m_current, items);
+                    m_current += count;
+                    return count;
+                }
+            private:
+                winrt::com_ptr<SuggestionsVector> m_owner;
+                uint32_t m_current{};
+            };
+
+            cppxaml::search::id_t IdAt(uint32_t index) const noexcept {
+                return m_all ? index : m_matches[index];
+            }
+
+            uint32_t PositionOf(cppxaml::search::id_t id) const noexcept {
+                return m_all ? id : static_cast<uint32_t>(std::find(m_matches.begin(), m_matches.end(), id) - m_matches.begin());
+            }
+
+            IInspectable Box(cppxaml::search::id_t id) const {
+                auto& boxed = m_boxed[id];
+                if (!boxed) {
+                    boxed = winrt::box_value(winrt::hstring(m_index->Items().Item(id)));
+                }
+                return boxed;
+            }
+
+            static constexpr size_t maxEdits = 256;
+
+            std::shared_ptr<const cppxaml::search::SubstringIndex> m_index;
+            std::vector<cppxaml::search::id_t> m_matches;
+            bool m_all{};
+            mutable std::unordered_map<cppxaml::search::id_t, IInspectable> m_boxed;
+            winrt::event<winrt::Windows::Foundation::Collections::VectorChangedEventHandler<IInspectable>> m_vectorChanged;
+        };
+
+        /**
+         * @brief Shows the matches of a search as the suggestions of an `AutoSuggestBox`.
+         * @param sender The `AutoSuggestBox`.
+         * @param index The index the matches refer to.
+         * @param matches The ids of the matching items.
+         * @param search The folded query.
+         * @param virtualize Whether to use a SuggestionsVector instead of boxing every match, see SearchOptions::virtualize.
+         * @param results The persistent vector to update with the matches, if any (see SearchOptions::minimalUpdates).
+        */
+        inline void ShowSuggestions(cppxaml::xaml::Controls::AutoSuggestBox sender, const std::shared_ptr<const cppxaml::search::SubstringIndex>& index, std::vector<cppxaml::search::id_t> matches, std::wstring_view search, bool virtualize,
+            const winrt::com_ptr<SuggestionsVector>& results = nullptr) {
+            const auto& catalog = index->Items();
+            auto exactMatch = search.empty() ? matches.end() : std::find_if(matches.begin(), matches.end(), [&](auto id) { return catalog.Folded(id) == search; });
+            winrt::hstring selected = exactMatch != matches.end() ? winrt::hstring(catalog.Item(*exactMatch)) : winrt::hstring{};
+
+            if (results) {
+                results->Update(std::move(matches), index);
+                // the first search (or the app) may have set another items source
+                auto source = results.as<winrt::Windows::Foundation::IInspectable>();
+                if (sender.ItemsSource() != source) {
+                    sender.ItemsSource(source);
+                }
+            }
+            else if (virtualize) {
+                sender.ItemsSource(winrt::make<SuggestionsVector>(index, std::move(matches)));
+            }
+            else {
+                auto suitableItems = winrt::single_threaded_vector<winrt::Windows::Foundation::IInspectable>();
+                for (auto id : matches) {
+                    suitableItems.Append(winrt::box_value(winrt::hstring(catalog.Item(id))));
+                }
+                sender.ItemsSource(suitableItems);
+            }
+            if (!selected.empty()) {
+                sender.Text(selected);
+            }
+        }
+
+        /**
+         * @brief Finds the suggestions for a search, as per the search options.
+         * @param index The index to search.
+         * @param incremental The incremental cache to search through, if any.
+         * @param search The folded query.
+         * @param options The search options.
+         * @return The ids of the matching items.
+        */
+        inline std::vector<cppxaml::search::id_t> FindSuggestions(const std::shared_ptr<const cppxaml::search::SubstringIndex>& index, cppxaml::search::IncrementalSearch* incremental, std::wstring_view search, const cppxaml::SearchOptions& options) {
+            if (incremental) {
+                // a StreamingCatalog may have produced a newer snapshot since the last search
+                incremental->Rebind(index);
+            }
+            auto matches = incremental ? incremental->FindFolded(search) : index->FindFolded(search);
+            if (options.ranked) {
+                return index->RankFolded(search, matches, options.maxResults, options.fuzzyBudget);
+            }
+            return matches;
+        }
+
+        /**
+         * @brief Builds the search index for a collection of items.
         */
         template<typename TItems>
-        struct Wrapper<cppxaml::xaml::Controls::AutoSuggestBox, TItems> : WrapperT<cppxaml::xaml::Controls::AutoSuggestBox>, std::enable_shared_from_this<Wrapper<cppxaml::xaml::Controls::AutoSuggestBox, TItems>> {
-            TItems m_items;
+        std::shared_ptr<const cppxaml::search::SubstringIndex> MakeSearchIndex(const TItems& items, bool caseInsensitive) {
+            return std::make_shared<const cppxaml::search::SubstringIndex>(items, caseInsensitive);
+        }
 
-            bool m_caseInsensitive{ false };
-            Wrapper() = delete;
-            Wrapper(const TItems& items) : m_items(items) {}
-            Wrapper(const Wrapper<cppxaml::xaml::Controls::AutoSuggestBox, TItems>& other) : m_items(other.m_items) {
-                if (other.m_textChangedToken) {
-                    SetEventHandlers(other.m_caseInsensitive);
+        /**
+         * @brief Returns the prebuilt index of a catalog, unless it was built with the other case mode.
+        */
+        inline std::shared_ptr<const cppxaml::search::SubstringIndex> MakeSearchIndex(const cppxaml::search::SuggestionCatalog& catalog, bool caseInsensitive) {
+            if (catalog.CaseInsensitive() == caseInsensitive) {
+                return catalog.Index();
+            }
+            return std::make_shared<const cppxaml::search::SubstringIndex>(catalog, caseInsensitive);
+        }
+
+        /**
+         * @brief Returns the index of what a streaming catalog has ingested so far. Searches over a StreamingCatalog always use its own case mode.
+        */
+        inline std::shared_ptr<const cppxaml::search::SubstringIndex> MakeSearchIndex(const cppxaml::search::StreamingCatalog& catalog, bool) {
+            return catalog.Snapshot();
+        }
+
+#ifdef USE_WINUI3
+        /**
+         * @brief Ingests a streaming catalog in slices of low-priority work on the UI thread, so that input and rendering keep priority.
+        */
+        inline void IndexInIdleSlices(winrt::Microsoft::UI::Dispatching::DispatcherQueue dispatcher, cppxaml::search::StreamingCatalog catalog) {
+            dispatcher.TryEnqueue(winrt::Microsoft::UI::Dispatching::DispatcherQueuePriority::Low, [dispatcher, catalog]() {
+                if (catalog.IndexFor(std::chrono::milliseconds(8))) {
+                    IndexInIdleSlices(dispatcher, catalog);
+                }
+                });
+        }
+#else
+        /**
+         * @brief Ingests a streaming catalog in slices of idle time on the UI thread, so that input and rendering keep priority.
+        */
+        inline void IndexInIdleSlices(winrt::Windows::UI::Core::CoreDispatcher dispatcher, cppxaml::search::StreamingCatalog catalog) {
+            dispatcher.RunIdleAsync([dispatcher, catalog](winrt::Windows::UI::Core::IdleDispatchedHandlerArgs const&) {
+                if (catalog.IndexFor(std::chrono::milliseconds(8))) {
+                    IndexInIdleSlices(dispatcher, catalog);
+                }
+                });
+        }
+#endif
+
+        /**
+         * @brief The search of an `AutoSuggestBox`, as a COM object so that the control can hold it in a private attached property.
+        */
+        struct XamlSearchHandler : winrt::implements<XamlSearchHandler, winrt::Windows::Foundation::IInspectable>, cppxaml::search::SearchHandler<cppxaml::xaml::Controls::AutoSuggestBox> {};
+
+        /**
+         * @brief Traits for cppxaml::search::AttachedSearchHandler that attach the search to an `AutoSuggestBox`. See cppxaml::details::SearchHandler.
+        */
+        struct XamlSearchHandlerTraits {
+            using control_t = cppxaml::xaml::Controls::AutoSuggestBox;
+            using handler_ptr = winrt::com_ptr<XamlSearchHandler>;
+
+            static handler_ptr get(const control_t& asb) {
+                handler_ptr handler;
+                if (auto value = asb.GetValue(Property())) {
+                    handler.copy_from(winrt::get_self<XamlSearchHandler>(value));
                 }
+                return handler;
             }
-            Wrapper(Wrapper&& other) : m_items(other.m_items),
-                m_textChangedToken(std::move(other.m_textChangedToken)),
-                m_suggestionChosenToken(std::move(other.m_suggestionChosenToken))
-            {
-                other.m_textChangedToken = {};
-                other.m_suggestionChosenToken = {};
+
+            static handler_ptr create(const control_t& asb) {
+                auto handler = winrt::make_self<XamlSearchHandler>();
+                asb.SetValue(Property(), *handler);
+                return handler;
             }
 
-            ~Wrapper() {
-                // Wrapper objects get destroyed as their only purpose is to facilitate creating the wrapped XAML objects
-                // However, wrapper objects set up event handlers (like these AutoSuggest ones). Therefore these event handlers must:
-                //      a) not use any state from Wrapper
-                //      b) not be de-registered upon Wrapper's destructor
-                //      c) be idempotent (as more than one event handler will likely run, as Wrappers can get copy-constructed/move constructed around).
+            template<typename F>
+            static void subscribe(const control_t& asb, F onUserInput) {
+                asb.TextChanged([onUserInput](control_t sender, cppxaml::xaml::Controls::AutoSuggestBoxTextChangedEventArgs args) {
+                    if (args.Reason() == cppxaml::xaml::Controls::AutoSuggestionBoxTextChangeReason::UserInput) {
+                        onUserInput(sender);
+                    }
+                    });
+                asb.SuggestionChosen([](control_t sender, cppxaml::xaml::Controls::AutoSuggestBoxSuggestionChosenEventArgs args) {
+                    sender.Text(winrt::unbox_value<winrt::hstring>(args.SelectedItem()));
+                    });
+            }
 
-                //if (m_textChangedToken) {
-                //    m_value.TextChanged(m_textChangedToken);
-                //}
-                //if (m_suggestionChosenToken) {
-                //    m_value.SuggestionChosen(m_suggestionChosenToken);
-                //}
+        private:
+            static cppxaml::xaml::DependencyProperty Property() {
+                static cppxaml::xaml::DependencyProperty property = cppxaml::xaml::DependencyProperty::RegisterAttached(L"CppXamlSearchHandler",
+                    winrt::xaml_typename<winrt::Windows::Foundation::IInspectable>(),
+                    winrt::xaml_typename<cppxaml::xaml::Controls::AutoSuggestBox>(),
+                    cppxaml::xaml::PropertyMetadata{ nullptr });
+                return property;
             }
+        };
+
+        /**
+         * @brief The search of an `AutoSuggestBox`, owned by the control itself (through a private attached property) rather than by the wrappers that set it up.
+         * @details The control's `TextChanged` and `SuggestionChosen` events get subscribed once, the first time search is enabled on it. See cppxaml::search::AttachedSearchHandler.
+        */
+        using SearchHandler = cppxaml::search::AttachedSearchHandler<XamlSearchHandlerTraits>;
+
+        /**
+         * @brief builder-style wrapper for `AutoSuggestBox`
+         * @tparam TItems the type of collection from which to initialize the `AutoSuggestBox`'s `Items`.
+        */
+        template<typename TItems>
+        struct Wrapper<cppxaml::xaml::Controls::AutoSuggestBox, TItems> : WrapperT<cppxaml::xaml::Controls::AutoSuggestBox>, std::enable_shared_from_this<Wrapper<cppxaml::xaml::Controls::AutoSuggestBox, TItems>> {
+            /**
+             * @brief The items the control was created from.
+             * @details The search index gets built from them when a search is enabled, and is then shared by copies of the wrapper rather than rebuilt.
+             * A cppxaml::search::SuggestionCatalog is indexed already, and copying it doesn't copy its items.
+            */
+            TItems m_items;
+
+            cppxaml::SearchOptions m_searchOptions{};
+            Wrapper() = delete;
+            Wrapper(const TItems& items) : m_items(items) {}
+            // Copies and moves wrap the same control. The search is owned by the control (see cppxaml::details::SearchHandler), not by the wrapper,
+            // so wrappers can be copied, moved and destroyed freely without adding or removing event handlers.
+            Wrapper(const Wrapper<cppxaml::xaml::Controls::AutoSuggestBox, TItems>& other) : WrapperT(other), m_items(other.m_items), m_searchOptions(other.m_searchOptions),
+                m_index(other.m_index), m_incremental(other.m_incremental), m_executor(other.m_executor), m_results(other.m_results) {}
+            Wrapper(Wrapper&& other) : WrapperT(std::move(other)),
+                m_items(std::move(other.m_items)),
+                m_searchOptions(other.m_searchOptions),
+                m_index(std::move(other.m_index)),
+                m_incremental(std::move(other.m_incremental)),
+                m_executor(std::move(other.m_executor)),
+                m_results(std::move(other.m_results))
+            {}
         private:
-            winrt::event_token m_textChangedToken{};
-            winrt::event_token m_suggestionChosenToken{};
-            void SetEventHandlers(bool caseInsensitive) {
-                m_caseInsensitive = caseInsensitive;
-                // work around MSVC bug: https://developercommunity.visualstudio.com/t/c3779-when-using-type-in-a-class-method-in-a-templ/1617634
-                auto GetReason = [](cppxaml::xaml::Controls::AutoSuggestBoxTextChangedEventArgs const& args) -> cppxaml::xaml::Controls::AutoSuggestionBoxTextChangeReason { return args.Reason(); };
-                m_textChangedToken = m_value.TextChanged([GetReason, caseInsensitive, items = this->m_items](cppxaml::xaml::Controls::AutoSuggestBox sender, cppxaml::xaml::Controls::AutoSuggestBoxTextChangedEventArgs args) {
-                    if (GetReason(args) == cppxaml::xaml::Controls::AutoSuggestionBoxTextChangeReason::UserInput) {
-                        std::wstring search = caseInsensitive ? utils::tolower(sender.Text()) : sender.Text().c_str();
-                        auto vec = TItems();
-
-                        for (const auto& entry : items) {
-                            auto str = caseInsensitive ? utils::tolower(entry) : entry.c_str();
-                            if (search == L"" || str.find(search) != -1) {
-                                vec.push_back(entry);
-                            }
-                        }
-                        auto suitableItems = winrt::single_threaded_vector<winrt::Windows::Foundation::IInspectable>();
-                        winrt::Windows::Foundation::IInspectable selected{ nullptr };
-                        for (const auto& e : vec) {
-                            auto boxed = winrt::box_value(e);
-                            if (utils::tolower(e) == search && search != L"") {
-                                selected = boxed;
+            // The index (and the catalog of items it holds) is immutable once built, so copies of the wrapper and their event handlers share it
+            // instead of re-indexing or copying the items.
+            std::shared_ptr<const cppxaml::search::SubstringIndex> m_index;
+            // Shared for the same reason; duplicate handlers then find the query already cached.
+            std::shared_ptr<cppxaml::search::IncrementalSearch> m_incremental;
+            // When set, searches run on the executor's thread. The incremental cache is then only ever touched from that thread.
+            std::shared_ptr<cppxaml::search::DebouncedExecutor> m_executor;
+            // The persistent items source, when SearchOptions::minimalUpdates is set. Shared so that every handler updates the same vector.
+            winrt::com_ptr<SuggestionsVector> m_results;
+            void SetEventHandlers(const cppxaml::SearchOptions& options) {
+                m_searchOptions = options;
+                if (!m_index || m_index->CaseInsensitive() != options.caseInsensitive) {
+                    m_index = MakeSearchIndex(m_items, options.caseInsensitive);
+                    m_incremental = nullptr;
+                }
+                if (!options.incremental) {
+                    m_incremental = nullptr;
+                }
+                else if (!m_incremental) {
+                    m_incremental = std::make_shared<cppxaml::search::IncrementalSearch>(m_index);
+                }
+                if (!options.minimalUpdates) {
+                    m_results = nullptr;
+                }
+                else if (!m_results || m_results->Index() != m_index) {
+                    m_results = winrt::make_self<SuggestionsVector>(m_index, std::vector<cppxaml::search::id_t>{});
+                }
+                if (!options.async) {
+                    m_executor = nullptr;
+                }
+                else if (!m_executor) {
+                    m_executor = std::make_shared<cppxaml::search::DebouncedExecutor>(options.debounce);
+                }
+                else {
+                    m_executor->Debounce(options.debounce);
+                }
+                // a streaming catalog's index grows as it gets ingested, so each search uses its latest snapshot
+                cppxaml::search::StreamingCatalog stream;
+                if constexpr (std::is_same_v<TItems, cppxaml::search::StreamingCatalog>) {
+                    stream = m_items;
+                }
+                SearchHandler::Attach(m_value)->Set([stream, baseIndex = m_index, incremental = m_incremental, executor = m_executor, results = m_results, options](const cppxaml::xaml::Controls::AutoSuggestBox& sender) {
+                    const auto index = stream ? stream.Snapshot() : baseIndex;
+                    auto search = index->Fold(sender.Text());
+                    if (executor) {
+#ifdef USE_WINUI3
+                        auto dispatcher = sender.DispatcherQueue();
+#else
+                        auto dispatcher = sender.Dispatcher();
+#endif
+                        executor->Post([index, incremental, results, options, search = std::move(search), weakSender = winrt::make_weak(sender), dispatcher](const cppxaml::search::CancellationToken& token) {
+                            auto matches = FindSuggestions(index, incremental.get(), search, options);
+                            if (token.IsCancelled()) {
+                                return;
                             }
-                            suitableItems.Append(boxed);
-                        }
-                        sender.ItemsSource(suitableItems);
-                        if (selected) {
-                            sender.Text(winrt::unbox_value<winrt::hstring>(selected));
-                        }
+                            // the user may have kept typing while this was being marshaled, so check again on the UI thread
+                            auto show = [index, token, weakSender, results, virtualize = options.virtualize, search, matches = std::move(matches)]() {
+                                if (!token.IsCancelled()) {
+                                    if (auto sender = weakSender.get()) {
+                                        ShowSuggestions(sender, index, matches, search, virtualize, results);
+                                    }
+                                }
+                            };
+#ifdef USE_WINUI3
+                            dispatcher.TryEnqueue(show);
+#else
+                            dispatcher.RunAsync(winrt::Windows::UI::Core::CoreDispatcherPriority::Normal, show);
+#endif
+                            });
+                    }
+                    else {
+                        ShowSuggestions(sender, index, FindSuggestions(index, incremental.get(), search, options), search, options.virtualize, results);
                     }
                 });
-                m_suggestionChosenToken = m_value.SuggestionChosen([](cppxaml::xaml::Controls::AutoSuggestBox sender, cppxaml::xaml::Controls::AutoSuggestBoxSuggestionChosenEventArgs args) {
-                    sender.Text(winrt::unbox_value<winrt::hstring>(args.SelectedItem()));
-                    });
-
             }
         public:
             /**
              * @brief Enables a default search experience for the AutoSuggestBox. The list of items shown gets filtered as the user searches, leaving only items that include the search string.
+             * @details The items get copied into a cppxaml::search::Catalog and indexed (see cppxaml::search::SubstringIndex) when this is called,
+             * so that each keystroke doesn't have to scan every item.
              * @param caseInsensitive Whether the search should be case insensitive or not. Default is true.
              * @return
             */
             auto EnableDefaultSearch(bool caseInsensitive = true) {
-                SetEventHandlers(caseInsensitive);
+                return EnableDefaultSearch(cppxaml::SearchOptions{ caseInsensitive });
+            }
+
+            /**
+             * @brief Enables a default search experience for the AutoSuggestBox, with the specified options.
+             * @param options The search options, see cppxaml::SearchOptions.
+             * @return
+             * @details Example:\n
+             * @code
+             * cppxaml::SearchOptions options;
+             * options.incremental = true;
+             * options.async = true;
+             * options.debounce = std::chrono::milliseconds(100);
+             * options.minimalUpdates = true;
+             * auto asb = cppxaml::AutoSuggestBox(GetFontFamilies())
+             *                  .EnableDefaultSearch(options);
+             * @endcode
+            */
+            auto EnableDefaultSearch(const cppxaml::SearchOptions& options) {
+                SetEventHandlers(options);
                 return *this;
             }
+
+            /**
+             * @brief Enables a ranked search experience for the AutoSuggestBox. Items that contain the search string come first, best matches first
+             * (e.g. items that start with it, or where it starts a word), followed by fuzzy matches that contain the characters of the search string in order.
+             * @param maxResults The maximum number of suggestions to show, or 0 for no limit. Default is 20.
+             * @param caseInsensitive Whether the search should be case insensitive or not. Default is true.
+             * @return
+            */
+            auto EnableRankedSearch(size_t maxResults = 20, bool caseInsensitive = true) {
+                cppxaml::SearchOptions options{ caseInsensitive };
+                options.ranked = true;
+                options.maxResults = maxResults;
+                return EnableDefaultSearch(options);
+            }
         };
 
         template<typename TItems>
@@ -330,82 +1058,175 @@ namespace cppxaml {
             }
         };
 
+        /**
+         * @brief Dispatches the clicks of all the items of a `MenuFlyout`, including the items of its submenus, to one handler.
+         * @details All the items share a single `Click` delegate, so each item only costs its subscription: an entry in the dispatcher's table, which maps the item to its event token.
+         * The table is refreshed each time the menu opens: items added since get subscribed, and items that were removed get unsubscribed.
+         * So each click of an item in the menu is dispatched exactly once; an item that was removed keeps being dispatched until the menu next opens.
+         * @tparam F The handler's type. It gets called with the sender and the `RoutedEventArgs`, both as const lvalues, so `(IInspectable sender, auto&)` lambdas work.
+        */
+        template<typename F>
+        struct MenuDispatcher : winrt::implements<MenuDispatcher<F>, winrt::Windows::Foundation::IInspectable> {
+            MenuDispatcher(F handler) : m_handler(std::move(handler)) {}
+
+            /**
+             * @brief Subscribes to the menu's items, and to its `Opening` event to pick up later changes. The menu keeps the dispatcher alive.
+            */
+            void Attach(const cppxaml::xaml::Controls::MenuFlyout& menu) {
+                // the items hold the click delegate, so it only holds the dispatcher weakly; an item that outlives the menu then does nothing
+                m_click = [weak = this->get_weak()](const winrt::Windows::Foundation::IInspectable& sender, const cppxaml::xaml::RoutedEventArgs& args) {
+                    if (auto self = weak.get()) {
+                        self->m_handler(sender, args);
+                    }
+                };
+                menu.Opening([self = this->get_strong()](const winrt::Windows::Foundation::IInspectable& sender, const winrt::Windows::Foundation::IInspectable&) {
+                    self->Refresh(sender.as<cppxaml::xaml::Controls::MenuFlyout>());
+                    });
+                Refresh(menu);
+            }
+
+            /**
+             * @brief Subscribes to the items added since the last refresh, and unsubscribes from the items that were removed.
+            */
+            void Refresh(const cppxaml::xaml::Controls::MenuFlyout& menu) {
+                Table current;
+                current.reserve(m_items.size());
+                Scan(menu.Items(), current);
+                for (auto& [key, subscription] : m_items) {
+                    if (current.find(key) == current.end()) {
+                        if (auto item = subscription.item.get()) {
+                            item.Click(subscription.token);
+                        }
+                    }
+                }
+                m_items.swap(current);
+            }
+
+            /**
+             * @brief The number of items clicks get dispatched for.
+            */
+            size_t ItemCount() const noexcept { return m_items.size(); }
+
+        private:
+            struct Subscription {
+                winrt::weak_ref<cppxaml::xaml::Controls::MenuFlyoutItem> item;
+                winrt::event_token token;
+            };
+            using Table = std::unordered_map<void*, Subscription>;
+
+            static void* Identity(const winrt::Windows::Foundation::IInspectable& item) {
+                return winrt::get_abi(item.as<winrt::Windows::Foundation::IUnknown>());
+            }
+
+            void Scan(const winrt::Windows::Foundation::Collections::IVector<cppxaml::xaml::Controls::MenuFlyoutItemBase>& items, Table& current) {
+                for (auto&& item : items) {
+                    if (auto mfi = item.try_as<cppxaml::xaml::Controls::MenuFlyoutItem>()) {
+                        const auto key = Identity(mfi);
+                        // an entry whose item is gone belongs to an earlier item that happened to live at the same address
+                        if (auto entry = m_items.find(key); entry != m_items.end() && entry->second.item.get()) {
+                            current.emplace(key, entry->second);
+                        }
+                        else {
+                            current.emplace(key, Subscription{ winrt::make_weak(mfi), mfi.Click(m_click) });
+                        }
+                    }
+                    else if (auto sub = item.try_as<cppxaml::xaml::Controls::MenuFlyoutSubItem>()) {
+                        Scan(sub.Items(), current);
+                    }
+                }
+            }
+
+            F m_handler;
+            cppxaml::xaml::RoutedEventHandler m_click;
+            Table m_items;
+        };
+
         /**
          * @brief builder-style wrapper for `MenuFlyout`
         */
         template<>
         struct Wrapper<cppxaml::xaml::Controls::MenuFlyout> : WrapperT<cppxaml::xaml::Controls::MenuFlyout> {
             /**
-             * @brief Sets up a centralized Click handler for all the MenuFlyoutItems in the MenuFlyout
+             * @brief Sets up a centralized Click handler for all the MenuFlyoutItems in the MenuFlyout, including those in submenus and those added later (see cppxaml::details::MenuDispatcher)
              * @tparam F 
              * @param f the lambda to call when a MenuFlyoutItem is clicked
              * @return 
             */
             template<typename F>
             auto CentralizedHandler(const F& f) {
-                if (m_eventHandlers.size() != 0) {
+                if (m_dispatcher) {
                     throw std::exception("Centralized handler already set");
                 }
 
-                for (auto i : m_value.Items()) {
-                    if (auto mfi = i.try_as<cppxaml::xaml::Controls::MenuFlyoutItem>()) {
-                        m_eventHandlers.push_back(mfi.Click([f](winrt::Windows::Foundation::IInspectable sender, cppxaml::xaml::RoutedEventArgs args) {
-                            f(sender, args);
-                            }));
-                    }
-                }
+                auto dispatcher = winrt::make_self<MenuDispatcher<F>>(f);
+                dispatcher->Attach(m_value);
+                m_dispatcher = *dispatcher;
                 return *this;
             }
-            std::vector<winrt::event_token> m_eventHandlers{};
-            ~Wrapper() {
-                // Wrapper goes out of scope when ShowAt is called, before the event handlers have had a chance to fire. Don't dismiss them for now.
-                /*
-                if (m_eventHandlers.size() == m_value.Items().Size()) {
-                    for (auto i = 0u; i < m_eventHandlers.size(); i++) {
-                        if (auto mfi = m_value.Items().GetAt(i).try_as<cppxaml::xaml::Controls::MenuFlyoutItem>()) {
-                            mfi.Click(m_eventHandlers[i]);
-                        }
-                        else {
-                            break; // bail, something is off
-                        }
-                    }
-                }
-                */
-            }
+            winrt::Windows::Foundation::IInspectable m_dispatcher{ nullptr };
         };
 
+        /**
+         * @brief Converts a portable grid length to its XAML counterpart.
+        */
+        inline cppxaml::xaml::GridLength ToGridLength(const cppxaml::layout::GridLength& length) noexcept {
+            return cppxaml::xaml::GridLength{ length.value, static_cast<cppxaml::xaml::GridUnitType>(length.unit) };
+        }
+
+        inline cppxaml::xaml::GridLength ToGridLength(const cppxaml::xaml::GridLength& length) noexcept {
+            return length;
+        }
+
+        /**
+         * @brief Parses a grid length natively, and falls back to the XAML type converter for syntax the native parser doesn't handle (e.g. `1in`).
+        */
+        template<typename CharT>
+        cppxaml::xaml::GridLength ParseGridLength(std::basic_string_view<CharT> v) {
+            if (auto length = cppxaml::layout::ParseGridLength(v)) {
+                return ToGridLength(*length);
+            }
+            winrt::hstring text;
+            if constexpr (std::is_same_v<CharT, wchar_t>) {
+                text = v;
+            }
+            else {
+                text = winrt::to_hstring(v);
+            }
+            return winrt::unbox_value<cppxaml::xaml::GridLength>(cppxaml::xaml::Markup::XamlBindingHelper::ConvertValue(winrt::xaml_typename<cppxaml::xaml::GridLength>(), winrt::box_value(text)));
+        }
+
         struct GridLength2 {
             operator cppxaml::xaml::GridLength() const { return m_length; }
-            GridLength2(double len) : m_length(cppxaml::xaml::GridLengthHelper::FromPixels(len)) {}
-            GridLength2(std::wstring_view v) {
-                m_length = winrt::unbox_value<cppxaml::xaml::GridLength>(cppxaml::xaml::Markup::XamlBindingHelper::ConvertValue(winrt::xaml_typename<cppxaml::xaml::GridLength>(), winrt::box_value(v)));
-            }
-            GridLength2(std::string_view v) : GridLength2(winrt::to_hstring(v)) {}
+            GridLength2(double len) : m_length(ToGridLength(cppxaml::layout::GridLength::Pixels(len))) {}
+            GridLength2(std::wstring_view v) : m_length(ParseGridLength(v)) {}
+            GridLength2(std::string_view v) : m_length(ParseGridLength(v)) {}
         private:
             cppxaml::xaml::GridLength m_length;
         };
         struct GridLengths {
             std::vector<cppxaml::xaml::GridLength> m_lengths;
             GridLengths(std::initializer_list<GridLength2>&& ls) {
+                m_lengths.reserve(ls.size());
                 for (auto& l : ls) {
                     m_lengths.push_back(l);
                 }
             }
             GridLengths(std::string_view sv) {
-                std::string_view last;
-                for (std::string_view::size_type pos = 0; pos < sv.length(); ) {
-                    auto nextDelimiter = sv.find(",", pos);
-                    last = sv.substr(pos, nextDelimiter - pos);
-                    auto len = winrt::unbox_value<cppxaml::xaml::GridLength>(cppxaml::xaml::Markup::XamlBindingHelper::ConvertValue(winrt::xaml_typename<cppxaml::xaml::GridLength>(), winrt::box_value(winrt::to_hstring(last))));
-                    m_lengths.push_back(len);
-
-                    if (nextDelimiter != -1) {
-                        pos = nextDelimiter + 1;
-                    }
-                    else {
-                        break;
-                    }
+                cppxaml::layout::ForEachGridLengthToken(sv, [this](std::string_view token) {
+                    m_lengths.push_back(ParseGridLength(token));
+                });
+            }
+
+            /**
+             * @brief The lengths as portable grid lengths, e.g. to precompute a layout with cppxaml::layout::SolveGrid.
+            */
+            std::vector<cppxaml::layout::GridLength> ToLayout() const {
+                std::vector<cppxaml::layout::GridLength> out;
+                out.reserve(m_lengths.size());
+                for (auto& l : m_lengths) {
+                    out.push_back({ l.Value, static_cast<cppxaml::layout::GridUnit>(l.GridUnitType) });
                 }
+                return out;
             }
         };
 
@@ -418,6 +1239,73 @@ namespace cppxaml {
             cppxaml::xaml::UIElement m_element{ nullptr };
         };
 
+        /**
+         * @brief The XAML calls of cppxaml::details::CollectionBuilder.
+        */
+        struct XamlCollectionTraits {
+            using element_t = cppxaml::xaml::UIElement;
+            using placed_t = UIElementInGrid;
+            using item_t = winrt::Windows::Foundation::IInspectable;
+
+            template<typename T>
+            static item_t box(const T& value) {
+                return winrt::box_value(value);
+            }
+
+            static auto children(const cppxaml::xaml::Controls::Panel& panel) {
+                return panel.Children();
+            }
+
+            static auto row_definitions(const cppxaml::xaml::Controls::Grid& grid) {
+                return grid.RowDefinitions();
+            }
+
+            static auto column_definitions(const cppxaml::xaml::Controls::Grid& grid) {
+                return grid.ColumnDefinitions();
+            }
+
+            static auto items(const cppxaml::xaml::Controls::ItemsControl& control) {
+                return control.Items();
+            }
+
+            template<typename TCollection, typename T>
+            static void replace_all(TCollection& collection, const T* first, const T* last) {
+                collection.ReplaceAll(winrt::array_view<const T>(first, last));
+            }
+
+            static cppxaml::xaml::Controls::RowDefinition create_row_definition() {
+                return cppxaml::xaml::Controls::RowDefinition();
+            }
+
+            static cppxaml::xaml::Controls::ColumnDefinition create_column_definition() {
+                return cppxaml::xaml::Controls::ColumnDefinition();
+            }
+
+            template<typename TLength>
+            static void set_height(const cppxaml::xaml::Controls::RowDefinition& rd, const TLength& length) {
+                rd.Height(ToGridLength(length));
+            }
+
+            template<typename TLength>
+            static void set_width(const cppxaml::xaml::Controls::ColumnDefinition& cd, const TLength& length) {
+                cd.Width(ToGridLength(length));
+            }
+
+            static cppxaml::xaml::FrameworkElement as_framework_element(const cppxaml::xaml::UIElement& element) {
+                return element.as<cppxaml::xaml::FrameworkElement>();
+            }
+
+            static void set_row(const cppxaml::xaml::FrameworkElement& fe, int row) {
+                cppxaml::xaml::Controls::Grid::SetRow(fe, row);
+            }
+
+            static void set_column(const cppxaml::xaml::FrameworkElement& fe, int column) {
+                cppxaml::xaml::Controls::Grid::SetColumn(fe, column);
+            }
+        };
+
+        using XamlCollectionBuilder = CollectionBuilder<XamlCollectionTraits>;
+
     } // namespace details
 
     /**
@@ -459,9 +1347,22 @@ namespace cppxaml {
     IF_ASSIGNABLE_CONTROL(Panel)
         MakePanel(const std::initializer_list<cppxaml::xaml::UIElement>& elems) {
         cppxaml::details::Wrapper<T> panel;
-        for (auto e : elems) {
-            panel->Children().Append(e);
-        }
+        cppxaml::details::XamlCollectionBuilder::AddChildren(*panel, elems);
+        return panel;
+    }
+
+    /**
+     * @brief Creates a XAML element of a type that is a subclass of `Panel`, from a range of children.
+     * @details The range can be a container, or a lazy view such as cppxaml::utils::transform_view, in which case the children are created as they get appended.
+     * @tparam T The XAML type.
+     * @param elems The range of elements; each element must be convertible to `UIElement` (e.g. a XAML element or a cppxaml wrapper).
+     * @return
+    */
+    template<typename T, typename TElements>
+    IF_ASSIGNABLE_CONTROL(Panel)
+        MakePanel(TElements&& elems) {
+        cppxaml::details::Wrapper<T> panel;
+        cppxaml::details::XamlCollectionBuilder::AddChildren(*panel, std::forward<TElements>(elems));
         return panel;
     }
 
@@ -486,11 +1387,34 @@ namespace cppxaml {
         return MakePanel<cppxaml::xaml::Controls::StackPanel>(elems);
     }
 
+    /**
+     * @brief Creates a `StackPanel` from a range of child controls, e.g. a cppxaml::utils::transform_view.
+     * @param elems The range of child controls.
+     * @return cppxaml::details::Wrapper<cppxaml::xaml::Controls::StackPanel>
+    */
+    template<typename TElements>
+    auto StackPanel(TElements&& elems) {
+        return MakePanel<cppxaml::xaml::Controls::StackPanel>(std::forward<TElements>(elems));
+    }
+
+    namespace details {
+        /**
+         * @brief Creates a `Grid` from ranges of row and column lengths (either XAML or cppxaml::layout grid lengths), and its children.
+        */
+        template<typename TRows, typename TColumns, typename TElements>
+        cppxaml::details::Wrapper<cppxaml::xaml::Controls::Grid> MakeGrid(const TRows& rows, const TColumns& columns, TElements&& elems) {
+            auto grid = cppxaml::details::Wrapper<cppxaml::xaml::Controls::Grid>();
+            XamlCollectionBuilder::AddGridContents(*grid, rows, columns, std::forward<TElements>(elems));
+            return grid;
+        }
+    }
+
     /**
      * @brief Creates a `Grid` with the specified rows, columns, and children.
      * @details
      * The row and column definitions are specified with the same syntax.\n
-     * This will be either an initializer list where each element is a height (a `double`, or the strings `"Auto"`, or `"N*"` where `N` is an integer), or a string with the corresponding format. \n\n
+     * This will be either an initializer list where each element is a height (a `double`, or the strings `"Auto"`, or `"N*"` where `N` is an integer), or a string with the corresponding format. \n
+     * With C++20, the definitions can also be `_rows` and `_cols` literals (see cppxaml::layout::literals), which are parsed at compile time.\n\n
      * Example usage:\n
      * @code
      *      auto grid = cppxaml::Grid({"40, *"}, {"Auto, Auto"}, {
@@ -502,36 +1426,30 @@ namespace cppxaml {
      * @endcode
      * @param gr The set of grid row definitions.
      * @param gc The set of grid column definitions.
-     * @param elems A list of cppxaml::details::UIElementInGrid entries where each entry is a `{rowNumber, columnNumber, myUIElement}`
+     * @param elems A list of cppxaml::details::UIElementInGrid entries where each entry is a `{rowNumber, columnNumber, myUIElement}`, or of `UIElement`s.
+     * Any range works, including lazy views like cppxaml::utils::transform_view, which avoid materializing the entries.
      * @return 
     */
-    template<typename TElements>
+    template<typename TElements = std::initializer_list<cppxaml::details::UIElementInGrid>>
     DOXY_RT(cppxaml::details::Wrapper<cppxaml::xaml::Controls::Grid>) 
         Grid(details::GridRows gr, cppxaml::details::GridColumns gc, TElements /*std::initializer_list<details::UIElementInGrid>& */&& elems) {
-        auto grid = cppxaml::details::Wrapper<cppxaml::xaml::Controls::Grid>();
-        for (auto& r : gr.m_lengths) {
-            auto rd = cppxaml::xaml::Controls::RowDefinition();
-            rd.Height(r);
-            grid->RowDefinitions().Append(rd);
-        }
-        for (auto& c : gc.m_lengths) {
-            auto cd = cppxaml::xaml::Controls::ColumnDefinition();
-            cd.Width(c);
-            grid->ColumnDefinitions().Append(cd);
-        }
+        return details::MakeGrid(gr.m_lengths, gc.m_lengths, std::forward<TElements>(elems));
+    }
 
-        for (auto& e : elems) {
-            if constexpr (std::is_assignable_v<cppxaml::details::UIElementInGrid, decltype(e)>) {
-                grid->Children().Append(e.m_element);
-                cppxaml::xaml::Controls::Grid::SetRow(e.m_element.as<cppxaml::xaml::FrameworkElement>(), e.m_row);
-                cppxaml::xaml::Controls::Grid::SetColumn(e.m_element.as<cppxaml::xaml::FrameworkElement>(), e.m_column);
-            }
-            else {
-                grid->Children().Append(e);
-            }
-        }
-        return grid;
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+    /**
+     * @brief Creates a `Grid` with rows and columns parsed at compile time, e.g. `cppxaml::Grid("40, *"_rows, "Auto, Auto"_cols, {...})`.
+     * @details No parsing or allocation happens for the definitions at runtime. See cppxaml::layout::literals.
+     * @param rows The row definitions, as a `_rows` literal.
+     * @param columns The column definitions, as a `_cols` literal.
+     * @param elems The children; see the other overload of cppxaml::Grid.
+    */
+    template<size_t Rows, size_t Columns, typename TElements = std::initializer_list<cppxaml::details::UIElementInGrid>>
+    DOXY_RT(cppxaml::details::Wrapper<cppxaml::xaml::Controls::Grid>)
+        Grid(const cppxaml::layout::GridSpec<cppxaml::layout::GridAxis::Rows, Rows>& rows, const cppxaml::layout::GridSpec<cppxaml::layout::GridAxis::Columns, Columns>& columns, TElements&& elems) {
+        return details::MakeGrid(rows.lengths, columns.lengths, std::forward<TElements>(elems));
     }
+#endif
 
     /**
      * @brief Creates a `TextBox`
@@ -558,20 +1476,15 @@ namespace cppxaml {
     IF_ASSIGNABLE_CONTROL_TITEMS(ItemsControl, TItems)
         MakeItemsControl(const TItems& /*std::initializer_list<Windows::Foundation::IInspectable>*/ items) {
         cppxaml::details::Wrapper<T, TItems> t(items);
-        for (auto& i : items) {
-            if constexpr (std::is_assignable_v<winrt::Windows::Foundation::IInspectable, decltype(i)>) {
-                t->Items().Append(i);
-            }
-            else {
-                t->Items().Append(winrt::box_value(i));
-            }
-        }
+        cppxaml::details::XamlCollectionBuilder::AddItems(*t, items);
         return t;
     }
 
     /**
      * @fn template<typename TItems> auto AutoSuggestBox(const TItems& svs)
      * @brief Creates an `AutoSuggestBox` from a list of items
+     * @details The wrapper keeps a copy of the items (cppxaml::details::Wrapper::m_items), and enabling a search indexes them into a second, contiguous copy.
+     * For large item sets, or sets shared by several controls, create the control from a cppxaml::search::SuggestionCatalog instead: the catalog is the only copy.
      * @tparam TItems
      * @param svs a list of `wstring_view` to populate the control from.
      * @return cppxaml::details::Wrapper<cppxaml::xaml::Controls::AutoSuggestBox, TItems> 
@@ -581,6 +1494,44 @@ namespace cppxaml {
         return MakeItemsControl<cppxaml::xaml::Controls::AutoSuggestBox, TItems>(svs);
     }
 
+    /**
+     * @brief Creates an `AutoSuggestBox` backed by a shared catalog.
+     * @details Neither the items nor the index get copied: the control references the catalog, and its search uses the catalog's prebuilt index
+     * when the case modes match. Rather than boxing every item into `Items`, the control's `ItemsSource` is a read-only vector that boxes items on demand.
+     * @param catalog The catalog, which may be shared by any number of controls.
+     * @return cppxaml::details::Wrapper<cppxaml::xaml::Controls::AutoSuggestBox, cppxaml::search::SuggestionCatalog>
+    */
+    inline auto AutoSuggestBox(const cppxaml::search::SuggestionCatalog& catalog) {
+        cppxaml::details::Wrapper<cppxaml::xaml::Controls::AutoSuggestBox, cppxaml::search::SuggestionCatalog> asb(catalog);
+        asb->ItemsSource(winrt::make<cppxaml::details::SuggestionsVector>(catalog.Index()));
+        return asb;
+    }
+
+    /**
+     * @brief Creates an `AutoSuggestBox` over a catalog that gets produced and indexed a chunk at a time.
+     * @details The control is returned right away, and the catalog gets ingested in idle slices of the UI thread (unless another control is already ingesting it).
+     * Searches cover the items ingested so far; see cppxaml::search::StreamingCatalog.\n
+     * Example:\n
+     * @code
+     * auto skus = std::make_shared<std::vector<std::wstring>>(LoadSkus());
+     * auto asb = cppxaml::AutoSuggestBox(cppxaml::search::StreamingCatalog(cppxaml::search::Chunks(skus, 4096)))
+     *                  .EnableDefaultSearch();
+     * @endcode
+     * @param catalog The catalog, which may be shared by any number of controls.
+     * @return cppxaml::details::Wrapper<cppxaml::xaml::Controls::AutoSuggestBox, cppxaml::search::StreamingCatalog>
+    */
+    inline auto AutoSuggestBox(const cppxaml::search::StreamingCatalog& catalog) {
+        cppxaml::details::Wrapper<cppxaml::xaml::Controls::AutoSuggestBox, cppxaml::search::StreamingCatalog> asb(catalog);
+        if (catalog.TryStartIngestion()) {
+#ifdef USE_WINUI3
+            cppxaml::details::IndexInIdleSlices(asb->DispatcherQueue(), catalog);
+#else
+            cppxaml::details::IndexInIdleSlices(asb->Dispatcher(), catalog);
+#endif
+        }
+        return asb;
+    }
+
     /**
      * @brief Creates a `TextBlock` from its text content.
      * @param text The text for the control.
@@ -665,4 +1616,196 @@ namespace cppxaml {
         return mf;
     }
 
+
+    namespace details {
+        /**
+         * @brief Traits for cppxaml::templates that create XAML elements. See cppxaml::ElementTemplate.
+        */
+        struct XamlTemplateTraits {
+            using object_t = cppxaml::xaml::DependencyObject;
+            using type_t = object_t(*)();
+            using property_t = cppxaml::xaml::DependencyProperty;
+            using value_t = winrt::Windows::Foundation::IInspectable;
+
+            template<typename TValue>
+            static value_t make_value(TValue&& value) {
+                if constexpr (std::is_assignable_v<winrt::Windows::Foundation::IInspectable, TValue>) {
+                    return std::forward<TValue>(value);
+                }
+                else {
+                    return winrt::box_value(std::forward<TValue>(value));
+                }
+            }
+
+            static object_t create(type_t type) {
+                return type();
+            }
+
+            static void set(const object_t& element, const property_t& property, const value_t& value) {
+                element.SetValue(property, value);
+            }
+
+            static void append_children(const object_t& parent, const object_t* children, size_t count) {
+                if (auto panel = parent.try_as<cppxaml::xaml::Controls::Panel>()) {
+                    std::vector<cppxaml::xaml::UIElement> elements;
+                    elements.reserve(count);
+                    for (size_t i = 0; i < count; i++) {
+                        elements.push_back(children[i].as<cppxaml::xaml::UIElement>());
+                    }
+                    panel.Children().ReplaceAll(elements);
+                    return;
+                }
+                if (count == 1) {
+                    if (auto contentControl = parent.try_as<cppxaml::xaml::Controls::ContentControl>()) {
+                        contentControl.Content(children[0]);
+                        return;
+                    }
+                    if (auto border = parent.try_as<cppxaml::xaml::Controls::Border>()) {
+                        border.Child(children[0].as<cppxaml::xaml::UIElement>());
+                        return;
+                    }
+                }
+                throw winrt::hresult_invalid_argument(L"Element templates can only add children to panels, or a single child to a ContentControl or a Border");
+            }
+        };
+    }
+
+    /**
+     * @brief Describes a tree of XAML elements, to be stamped out with cppxaml::ElementTemplate. Create one with cppxaml::Element.
+     * @details Property values are boxed once, when set on the spec, and the boxes are shared by all instances; so only use values that can be shared (e.g. numbers, strings, enums, brushes),
+     * and cppxaml::templates::ElementSpec::Initialize for anything that must be created per instance (e.g. a Grid's row and column definitions).
+    */
+    using ElementSpec = cppxaml::templates::ElementSpec<details::XamlTemplateTraits>;
+
+    /**
+     * @brief A tree of XAML elements, flattened from a cppxaml::ElementSpec into a list of instructions, that creates instances of it.
+     * @details Unlike re-running builder code for each instance, nothing is parsed or boxed per instance, and the children of each element are added with a single call.\n
+     * Example:\n
+     * @code
+     * auto row = cppxaml::ElementTemplate(cppxaml::Element<Controls::Grid>()
+     *     .Initialize([](auto& grid) {
+     *         auto columns = grid.as<Controls::Grid>().ColumnDefinitions();
+     *         columns.Append(Controls::ColumnDefinition());
+     *         columns.Append(Controls::ColumnDefinition());
+     *     })
+     *     .Children({
+     *         cppxaml::Element<Controls::TextBlock>().Set(Controls::TextBlock::TextProperty(), L"Name"),
+     *         cppxaml::Element<Controls::TextBox>().Set(Controls::Grid::ColumnProperty(), 1),
+     *     }));
+     * auto rows = row.Instantiate(100);
+     * @endcode
+    */
+    using ElementTemplate = cppxaml::templates::ElementTemplate<details::XamlTemplateTraits>;
+
+    /**
+     * @brief Starts a cppxaml::ElementSpec for an element of type `T`.
+     * @tparam T The XAML type, e.g. `Controls::TextBlock`.
+    */
+    template<typename T>
+    cppxaml::ElementSpec Element() {
+        return cppxaml::ElementSpec([]() -> cppxaml::xaml::DependencyObject { return T(); });
+    }
+
+
+    namespace details {
+        /**
+         * @brief Traits for cppxaml::templates::RecyclePool that pool XAML elements. See cppxaml::ElementPool.
+        */
+        struct XamlRecycleTraits {
+            using element_t = cppxaml::xaml::FrameworkElement;
+            // the names returned by winrt::name_of have static storage
+            using type_key_t = std::wstring_view;
+
+            /**
+             * @brief Clears the local values that builders commonly set, so that a reused element looks like a new one.
+             * @return `false` if the element is still in a tree.
+            */
+            static bool reset(element_t& element) {
+                if (element.Parent()) {
+                    return false;
+                }
+                for (const auto& property : {
+                        cppxaml::xaml::FrameworkElement::NameProperty(),
+                        cppxaml::xaml::FrameworkElement::TagProperty(),
+                        cppxaml::xaml::FrameworkElement::DataContextProperty(),
+                        cppxaml::xaml::FrameworkElement::MarginProperty(),
+                        cppxaml::xaml::FrameworkElement::WidthProperty(),
+                        cppxaml::xaml::FrameworkElement::HeightProperty(),
+                        cppxaml::xaml::UIElement::VisibilityProperty(),
+                        cppxaml::xaml::UIElement::OpacityProperty(),
+                        cppxaml::xaml::Controls::Grid::RowProperty(),
+                        cppxaml::xaml::Controls::Grid::ColumnProperty(),
+                        cppxaml::xaml::Controls::Grid::RowSpanProperty(),
+                        cppxaml::xaml::Controls::Grid::ColumnSpanProperty(),
+                    }) {
+                    element.ClearValue(property);
+                }
+                if (auto contentControl = element.try_as<cppxaml::xaml::Controls::ContentControl>()) {
+                    contentControl.ClearValue(cppxaml::xaml::Controls::ContentControl::ContentProperty());
+                }
+                else if (auto textBlock = element.try_as<cppxaml::xaml::Controls::TextBlock>()) {
+                    textBlock.ClearValue(cppxaml::xaml::Controls::TextBlock::TextProperty());
+                }
+                else if (auto panel = element.try_as<cppxaml::xaml::Controls::Panel>()) {
+                    panel.Children().Clear();
+                }
+                return true;
+            }
+        };
+    }
+
+    /**
+     * @brief A pool of detached XAML elements, to reuse them rather than create new ones.
+     * @details Elements are keyed by their type (and optionally a template id), and reset when released (see cppxaml::details::XamlRecycleTraits::reset).
+     * Event handlers and other state the reset doesn't know about stay on the element; pass a custom reset, or use template ids to only reuse elements that were set up the same way.\n
+     * Example:\n
+     * @code
+     * cppxaml::ElementPool pool(512);
+     * auto tb = pool.Acquire<Controls::TextBlock>();
+     * tb.Text(L"hello");
+     * // ... once tb has been removed from its parent:
+     * pool.Release(tb);
+     * auto hits = pool.Stats().hits;
+     * @endcode
+    */
+    class ElementPool {
+    public:
+        using Pool = cppxaml::templates::RecyclePool<details::XamlRecycleTraits>;
+
+        /**
+         * @brief Creates a pool.
+         * @param capacity The maximum number of elements the pool holds on to.
+         * @param reset Resets released elements; defaults to cppxaml::details::XamlRecycleTraits::reset.
+        */
+        explicit ElementPool(size_t capacity = 256, Pool::Reset reset = details::XamlRecycleTraits::reset) : m_pool(capacity, std::move(reset)) {}
+
+        /**
+         * @brief Returns a pooled element of type `T` if there is one, or a new one otherwise.
+         * @param templateId Only reuse elements released with the same id.
+        */
+        template<typename T>
+        T Acquire(uint32_t templateId = 0) {
+            return m_pool.Acquire({ winrt::name_of<T>(), templateId }, []() -> cppxaml::xaml::FrameworkElement { return T(); }).template as<T>();
+        }
+
+        /**
+         * @brief Returns an element that is no longer in use to the pool. Remove it from its parent first.
+         * @tparam T The type the element was acquired as.
+         * @return Whether the element got pooled (it doesn't if the pool is full or the reset fails).
+        */
+        template<typename T>
+        bool Release(const T& element, uint32_t templateId = 0) {
+            return m_pool.Release({ winrt::name_of<T>(), templateId }, element);
+        }
+
+        void Capacity(size_t capacity) { m_pool.Capacity(capacity); }
+        size_t Capacity() const noexcept { return m_pool.Capacity(); }
+        void Clear() { m_pool.Clear(); }
+        size_t size() const noexcept { return m_pool.size(); }
+        const Pool::Statistics& Stats() const noexcept { return m_pool.Stats(); }
+
+    private:
+        Pool m_pool;
+    };
+
 }
\ No newline at end of file
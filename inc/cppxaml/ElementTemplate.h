@@ -0,0 +1,229 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+/** @file
+* @author Alexander Sklar
+* @section LICENSE
+ * Copyright (c) Alexander Sklar
+ *
+ * Licensed under the MIT license
+*/
+
+namespace cppxaml {
+
+    /**
+     * @namespace cppxaml::templates
+     * @brief Element templates: describe a tree of elements once, then stamp out many instances of it.\n
+     * The description and its flattening don't depend on XAML; the elements get created through a traits class (see cppxaml::templates::ElementTemplate).
+     * Controls.h provides the XAML traits, as cppxaml::ElementSpec and cppxaml::ElementTemplate.
+    */
+    namespace templates {
+        template<typename Traits>
+        class ElementTemplate;
+
+        /**
+         * @brief A value-type description of an element: its type, property values (including attached properties), initializers, and children.
+         * @tparam Traits Defines `type_t` (what creates an element), `property_t`, `value_t`, `object_t`, and how to apply them (see cppxaml::templates::ElementTemplate).
+        */
+        template<typename Traits>
+        class ElementSpec {
+        public:
+            using type_t = typename Traits::type_t;
+            using property_t = typename Traits::property_t;
+            using value_t = typename Traits::value_t;
+            using object_t = typename Traits::object_t;
+            using Initializer = std::function<void(const object_t&)>;
+
+            explicit ElementSpec(type_t type) : m_type(std::move(type)) {}
+
+            /**
+             * @brief Sets a property on every instance. The value is converted (e.g. boxed) once, here, and shared by all instances.
+            */
+            template<typename TValue>
+            ElementSpec& Set(property_t property, TValue&& value) & {
+                m_setters.emplace_back(std::move(property), Traits::make_value(std::forward<TValue>(value)));
+                return *this;
+            }
+            template<typename TValue>
+            ElementSpec&& Set(property_t property, TValue&& value) && {
+                return std::move(Set(std::move(property), std::forward<TValue>(value)));
+            }
+
+            /**
+             * @brief Runs a function on every instance once its properties are set, and before its children are added; e.g. for state that can't be shared between instances.
+            */
+            ElementSpec& Initialize(Initializer initializer) & {
+                m_initializers.push_back(std::move(initializer));
+                return *this;
+            }
+            ElementSpec&& Initialize(Initializer initializer) && {
+                return std::move(Initialize(std::move(initializer)));
+            }
+
+            /**
+             * @brief Adds children.
+            */
+            ElementSpec& Children(std::initializer_list<ElementSpec> children) & {
+                m_children.insert(m_children.end(), children.begin(), children.end());
+                return *this;
+            }
+            ElementSpec&& Children(std::initializer_list<ElementSpec> children) && {
+                return std::move(Children(children));
+            }
+
+            /**
+             * @brief Adds a child.
+            */
+            ElementSpec& Child(ElementSpec child) & {
+                m_children.push_back(std::move(child));
+                return *this;
+            }
+            ElementSpec&& Child(ElementSpec child) && {
+                return std::move(Child(std::move(child)));
+            }
+
+        private:
+            friend class ElementTemplate<Traits>;
+            type_t m_type;
+            std::vector<std::pair<property_t, value_t>> m_setters;
+            std::vector<Initializer> m_initializers;
+            std::vector<ElementSpec> m_children;
+        };
+
+        /**
+         * @brief A cppxaml::templates::ElementSpec flattened into a list of instructions, which creates instances of the tree without walking the spec.
+         * @details `Traits` must provide:
+         * - `type_t`, `property_t`, `value_t` and `object_t` types;
+         * - `static value_t make_value(V&&)`, to convert property values given to cppxaml::templates::ElementSpec::Set;
+         * - `static object_t create(const type_t&)`;
+         * - `static void set(const object_t&, const property_t&, const value_t&)`;
+         * - `static void append_children(const object_t& parent, const object_t* children, size_t count)`, which gets all of an element's children at once.
+         *
+         * Example, with the XAML traits from Controls.h:\n
+         * @code
+         * auto row = cppxaml::ElementTemplate(cppxaml::Element<Controls::StackPanel>()
+         *     .Set(Controls::StackPanel::OrientationProperty(), Controls::Orientation::Horizontal)
+         *     .Children({
+         *         cppxaml::Element<Controls::TextBlock>().Set(Controls::TextBlock::TextProperty(), L"Name"),
+         *         cppxaml::Element<Controls::TextBox>().Set(Controls::TextBox::WidthProperty(), 200.0),
+         *     }));
+         * auto rows = row.Instantiate(100);
+         * @endcode
+        */
+        template<typename Traits>
+        class ElementTemplate {
+        public:
+            using object_t = typename Traits::object_t;
+
+            explicit ElementTemplate(const ElementSpec<Traits>& root) {
+                Flatten(root, 0);
+            }
+
+            /**
+             * @brief Creates an instance of the tree, and returns its root.
+            */
+            object_t Instantiate() const {
+                std::vector<object_t> stack;
+                stack.reserve(m_maxStack);
+                return Run(stack);
+            }
+
+            /**
+             * @brief Creates `count` instances of the tree.
+            */
+            std::vector<object_t> Instantiate(size_t count) const {
+                std::vector<object_t> roots;
+                roots.reserve(count);
+                std::vector<object_t> stack;
+                stack.reserve(m_maxStack);
+                for (size_t i = 0; i < count; i++) {
+                    roots.push_back(Run(stack));
+                }
+                return roots;
+            }
+
+            /**
+             * @brief The number of elements in each instance.
+            */
+            size_t ElementCount() const noexcept { return m_types.size(); }
+            /**
+             * @brief The number of instructions run per instance.
+            */
+            size_t InstructionCount() const noexcept { return m_program.size(); }
+
+        private:
+            enum class Op : uint8_t {
+                Create,         // push a new element of m_types[operand]
+                Set,            // apply m_setters[operand] to the top element
+                Initialize,     // run m_initializers[operand] on the top element
+                AppendChildren, // pop the top `operand` elements, and append them to the element below
+            };
+            struct Instruction {
+                Op op;
+                uint32_t operand;
+            };
+
+            void Flatten(const ElementSpec<Traits>& spec, size_t depth) {
+                Emit(Op::Create, m_types.size());
+                m_types.push_back(spec.m_type);
+                for (auto& setter : spec.m_setters) {
+                    Emit(Op::Set, m_setters.size());
+                    m_setters.push_back(setter);
+                }
+                for (auto& initializer : spec.m_initializers) {
+                    Emit(Op::Initialize, m_initializers.size());
+                    m_initializers.push_back(initializer);
+                }
+                // children stay on the stack until they're all created, so that they can be appended in one go
+                for (size_t i = 0; i < spec.m_children.size(); i++) {
+                    Flatten(spec.m_children[i], depth + 1 + i);
+                }
+                if (!spec.m_children.empty()) {
+                    Emit(Op::AppendChildren, spec.m_children.size());
+                }
+                m_maxStack = (std::max)(m_maxStack, depth + 1);
+            }
+
+            void Emit(Op op, size_t operand) {
+                m_program.push_back({ op, static_cast<uint32_t>(operand) });
+            }
+
+            object_t Run(std::vector<object_t>& stack) const {
+                for (const auto& instruction : m_program) {
+                    switch (instruction.op) {
+                    case Op::Create:
+                        stack.push_back(Traits::create(m_types[instruction.operand]));
+                        break;
+                    case Op::Set:
+                        Traits::set(stack.back(), m_setters[instruction.operand].first, m_setters[instruction.operand].second);
+                        break;
+                    case Op::Initialize:
+                        m_initializers[instruction.operand](stack.back());
+                        break;
+                    case Op::AppendChildren: {
+                        const size_t first = stack.size() - instruction.operand;
+                        Traits::append_children(stack[first - 1], stack.data() + first, instruction.operand);
+                        stack.erase(stack.begin() + static_cast<ptrdiff_t>(first), stack.end());
+                        break;
+                    }
+                    }
+                }
+                auto root = std::move(stack.back());
+                stack.clear();
+                return root;
+            }
+
+            std::vector<Instruction> m_program;
+            std::vector<typename Traits::type_t> m_types;
+            std::vector<std::pair<typename Traits::property_t, typename Traits::value_t>> m_setters;
+            std::vector<typename ElementSpec<Traits>::Initializer> m_initializers;
+            size_t m_maxStack{ 0 };
+        };
+    }
+}
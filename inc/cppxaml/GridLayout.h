@@ -0,0 +1,307 @@
+#pragma once
+#include <cppxaml/Layout.h>
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/** @file
+* @author Alexander Sklar
+* @section LICENSE
+ * Copyright (c) Alexander Sklar
+ *
+ * Licensed under the MIT license
+*/
+
+namespace cppxaml {
+    namespace layout {
+        /**
+         * @brief A width and a height. Either can be infinite, to mean "unconstrained".
+        */
+        struct Size {
+            double width{};
+            double height{};
+        };
+
+        /**
+         * @brief A rectangle, as produced by arranging a grid.
+        */
+        struct Rect {
+            double x{};
+            double y{};
+            double width{};
+            double height{};
+        };
+
+        /**
+         * @brief A row or column definition: its length, and the `MinHeight`/`MaxHeight` (or `MinWidth`/`MaxWidth`) it is clamped to.
+        */
+        struct GridTrack {
+            GridLength length{ GridLength::Star() };
+            double min{ 0 };
+            double max{ std::numeric_limits<double>::infinity() };
+
+            constexpr GridTrack() noexcept = default;
+            constexpr GridTrack(GridLength l, double minimum = 0, double maximum = std::numeric_limits<double>::infinity()) noexcept : length(l), min(minimum), max(maximum) {}
+        };
+
+        /**
+         * @brief A child of a grid: the cell it is in, its spans, and its desired size (i.e. the size it measured to).
+        */
+        struct GridCell {
+            size_t row{};
+            size_t column{};
+            size_t rowSpan{ 1 };
+            size_t columnSpan{ 1 };
+            Size desired{};
+        };
+
+        /**
+         * @brief The result of cppxaml::layout::SolveGrid: the size of each row and column, and where they start.
+        */
+        struct GridLayout {
+            std::vector<double> rowHeights;
+            std::vector<double> columnWidths;
+            std::vector<double> rowOffsets;
+            std::vector<double> columnOffsets;
+            /**
+             * @brief The size the grid needs to show its content, as its `DesiredSize` would be.
+            */
+            Size desired{};
+
+            /**
+             * @brief The rectangle a cell gets arranged in.
+            */
+            Rect CellRect(const GridCell& cell) const noexcept {
+                const auto [row, rowEnd] = Range(cell.row, cell.rowSpan, rowHeights.size());
+                const auto [column, columnEnd] = Range(cell.column, cell.columnSpan, columnWidths.size());
+                return {
+                    columnOffsets[column], rowOffsets[row],
+                    columnOffsets[columnEnd - 1] + columnWidths[columnEnd - 1] - columnOffsets[column],
+                    rowOffsets[rowEnd - 1] + rowHeights[rowEnd - 1] - rowOffsets[row],
+                };
+            }
+
+            /**
+             * @brief The index range `[first, end)` a cell covers along an axis of `count` tracks, clamped like XAML does.
+            */
+            static std::pair<size_t, size_t> Range(size_t index, size_t span, size_t count) noexcept {
+                const auto first = (std::min)(index, count - 1);
+                return { first, (std::min)(first + (std::max)(span, size_t{ 1 }), count) };
+            }
+        };
+
+        namespace details {
+            constexpr GridTrack to_track(const GridTrack& track) noexcept { return track; }
+            constexpr GridTrack to_track(const GridLength& length) noexcept { return GridTrack(length); }
+
+            template<typename TTracks>
+            std::vector<GridTrack> to_tracks(const TTracks& tracks) {
+                std::vector<GridTrack> out;
+                for (const auto& t : tracks) {
+                    out.push_back(to_track(t));
+                }
+                if (out.empty()) {
+                    // a grid without definitions has a single star row/column
+                    out.emplace_back(GridLength::Star());
+                }
+                return out;
+            }
+
+            struct AxisItem {
+                size_t first;
+                size_t end;
+                double desired;
+            };
+
+            inline double clamp_track(const GridTrack& t, double v) noexcept {
+                return (std::max)(t.min, (std::min)(t.max, v));
+            }
+
+            /**
+             * @brief Gives each star track its share of `space`, by weight, honoring min/max.
+             * @details A track whose share falls outside its bounds is fixed at the bound, and the rest is redistributed among the others, until all shares fit.
+            */
+            inline void resolve_stars(const std::vector<GridTrack>& tracks, std::vector<double>& sizes, double space) {
+                std::vector<size_t> active;
+                for (size_t i = 0; i < tracks.size(); i++) {
+                    if (tracks[i].length.unit == GridUnit::Star) {
+                        active.push_back(i);
+                    }
+                }
+                while (!active.empty()) {
+                    double weight = 0;
+                    for (auto i : active) weight += (std::max)(tracks[i].length.value, 0.0);
+                    const double remaining = (std::max)(space, 0.0);
+                    const auto share = [&](size_t i) { return weight > 0 ? remaining * (std::max)(tracks[i].length.value, 0.0) / weight : 0.0; };
+
+                    // fix the tracks that violate their minimum first, since that takes space from the others; then those that exceed their maximum
+                    bool fixed = false;
+                    for (const bool minimums : { true, false }) {
+                        for (auto it = active.begin(); it != active.end();) {
+                            const auto& t = tracks[*it];
+                            const double s = share(*it);
+                            if (minimums ? s < t.min : s > t.max) {
+                                sizes[*it] = minimums ? t.min : t.max;
+                                space -= sizes[*it];
+                                it = active.erase(it);
+                                fixed = true;
+                            }
+                            else {
+                                ++it;
+                            }
+                        }
+                        if (fixed) break;
+                    }
+                    if (!fixed) {
+                        for (auto i : active) sizes[i] = share(i);
+                        break;
+                    }
+                }
+            }
+
+            /**
+             * @brief Solves one axis of a grid. Returns the desired extent, and fills in the track sizes.
+            */
+            inline double solve_axis(const std::vector<GridTrack>& tracks, std::vector<AxisItem>& items, double available, std::vector<double>& sizes) {
+                const bool infinite = !(available < std::numeric_limits<double>::infinity());
+                // with unconstrained space, star tracks size to their content, like Auto
+                const auto isAuto = [&](const GridTrack& t) { return t.length.unit == GridUnit::Auto || (infinite && t.length.unit == GridUnit::Star); };
+
+                sizes.assign(tracks.size(), 0);
+                std::vector<double> starContent(tracks.size(), 0);
+                for (size_t i = 0; i < tracks.size(); i++) {
+                    const auto& t = tracks[i];
+                    sizes[i] = clamp_track(t, t.length.unit == GridUnit::Pixel ? t.length.value : 0);
+                }
+
+                // children that sit in a single track
+                for (const auto& item : items) {
+                    if (item.end - item.first != 1) continue;
+                    const auto& t = tracks[item.first];
+                    if (isAuto(t)) {
+                        sizes[item.first] = (std::max)(sizes[item.first], clamp_track(t, item.desired));
+                    }
+                    else if (t.length.unit == GridUnit::Star) {
+                        starContent[item.first] = (std::max)(starContent[item.first], item.desired);
+                    }
+                }
+
+                // spanning children, narrowest spans first, grow the auto tracks they span; spans that include a star track leave it to the stars to absorb them
+                std::stable_sort(items.begin(), items.end(), [](const AxisItem& a, const AxisItem& b) { return a.end - a.first < b.end - b.first; });
+                std::vector<size_t> autos;
+                double spannedStarUnit = 0;
+                for (const auto& item : items) {
+                    if (item.end - item.first < 2) continue;
+                    autos.clear();
+                    double spanned = 0;
+                    double spannedStarWeight = 0;
+                    for (size_t i = item.first; i < item.end; i++) {
+                        if (isAuto(tracks[i])) autos.push_back(i);
+                        if (!isAuto(tracks[i]) && tracks[i].length.unit == GridUnit::Star) {
+                            spannedStarWeight += (std::max)(tracks[i].length.value, 0.0);
+                        }
+                        else {
+                            spanned += sizes[i];
+                        }
+                    }
+                    double excess = item.desired - spanned;
+                    if (spannedStarWeight > 0) {
+                        // the stars need a large enough unit for their share of the span to hold what the other tracks don't
+                        spannedStarUnit = (std::max)(spannedStarUnit, excess / spannedStarWeight);
+                        continue;
+                    }
+                    if (autos.empty()) continue;
+                    // split the excess evenly, handing what tracks at their maximum can't take to the others
+                    while (excess > 0 && !autos.empty()) {
+                        const double each = excess / static_cast<double>(autos.size());
+                        const size_t growing = autos.size();
+                        for (auto it = autos.begin(); it != autos.end();) {
+                            const double grown = (std::min)(tracks[*it].max, sizes[*it] + each);
+                            excess -= grown - sizes[*it];
+                            sizes[*it] = grown;
+                            it = grown >= tracks[*it].max ? autos.erase(it) : it + 1;
+                        }
+                        if (autos.size() == growing) {
+                            // no track hit its maximum, so the excess has been absorbed (up to rounding)
+                            break;
+                        }
+                    }
+                }
+
+                double fixedSize = 0;
+                double starWeight = 0;
+                double starUnit = spannedStarUnit;
+                double starMinimums = 0;
+                for (size_t i = 0; i < tracks.size(); i++) {
+                    const auto& t = tracks[i];
+                    if (!isAuto(t) && t.length.unit == GridUnit::Star) {
+                        const double w = (std::max)(t.length.value, 0.0);
+                        starWeight += w;
+                        starMinimums += t.min;
+                        if (w > 0) starUnit = (std::max)(starUnit, clamp_track(t, starContent[i]) / w);
+                    }
+                    else {
+                        fixedSize += sizes[i];
+                    }
+                }
+                // the grid wants enough room for every star track to fit its content at its proportion
+                const double desired = fixedSize + (std::max)(starUnit * starWeight, starMinimums);
+
+                if (!infinite) {
+                    resolve_stars(tracks, sizes, available - fixedSize);
+                }
+                return desired;
+            }
+        }
+
+        /**
+         * @brief Computes the row and column sizes of a grid, the way XAML's `Grid` lays out.
+         * @details Pixel tracks take their length, Auto tracks fit the children in them, and star tracks share the remaining space by weight;
+         * all of them are clamped to their min/max. Children spanning several tracks grow the Auto tracks they span (evenly), unless they span a star track:
+         * the star tracks then absorb what the other spanned tracks don't hold, which counts toward the grid's desired size.
+         * When `available` is infinite along an axis, star tracks along it behave as Auto, as in XAML.\n
+         * The desired sizes of the children are inputs: this doesn't measure content, so measure (or estimate) the children beforehand, e.g. to size virtualized lists or pick breakpoints without running the XAML layout pass.\n
+         * Example:\n
+         * @code
+         * using namespace cppxaml::layout::literals;
+         * std::vector<cppxaml::layout::GridCell> cells{ { 0, 0, 1, 1, { 120, 32 } }, { 1, 0, 1, 2, { 300, 20 } } };
+         * auto layout = cppxaml::layout::SolveGrid("Auto, *"_rows, "Auto, *"_cols, cells, { 800, 600 });
+         * auto rect = layout.CellRect(cells[1]);
+         * @endcode
+         * @param rows The row definitions: a range of cppxaml::layout::GridLength (e.g. a `_rows` literal) or cppxaml::layout::GridTrack.
+         * @param columns The column definitions, likewise.
+         * @param cells The children. Out of range rows, columns and spans get clamped, as in XAML.
+         * @param available The size the grid gets arranged in; either dimension can be infinite.
+         * @return The sizes and offsets of the rows and columns, and the grid's desired size.
+        */
+        template<typename TRows, typename TColumns, typename TCells>
+        GridLayout SolveGrid(const TRows& rows, const TColumns& columns, const TCells& cells, Size available) {
+            const auto rowTracks = details::to_tracks(rows);
+            const auto columnTracks = details::to_tracks(columns);
+            std::vector<details::AxisItem> rowItems;
+            std::vector<details::AxisItem> columnItems;
+            for (const GridCell& cell : cells) {
+                const auto [row, rowEnd] = GridLayout::Range(cell.row, cell.rowSpan, rowTracks.size());
+                const auto [column, columnEnd] = GridLayout::Range(cell.column, cell.columnSpan, columnTracks.size());
+                rowItems.push_back({ row, rowEnd, cell.desired.height });
+                columnItems.push_back({ column, columnEnd, cell.desired.width });
+            }
+
+            GridLayout layout;
+            layout.desired.height = details::solve_axis(rowTracks, rowItems, available.height, layout.rowHeights);
+            layout.desired.width = details::solve_axis(columnTracks, columnItems, available.width, layout.columnWidths);
+            for (auto [sizes, offsets] : { std::pair{ &layout.rowHeights, &layout.rowOffsets }, std::pair{ &layout.columnWidths, &layout.columnOffsets } }) {
+                offsets->resize(sizes->size());
+                double offset = 0;
+                for (size_t i = 0; i < sizes->size(); i++) {
+                    (*offsets)[i] = offset;
+                    offset += (*sizes)[i];
+                }
+            }
+            return layout;
+        }
+    }
+}
@@ -0,0 +1,262 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+/** @file
+* @author Alexander Sklar
+* @section LICENSE
+ * Copyright (c) Alexander Sklar
+ *
+ * Licensed under the MIT license
+*/
+
+namespace cppxaml {
+
+    /**
+     * @namespace cppxaml::layout
+     * @brief Layout primitives used by the `Grid` builder.\n
+     * Nothing in this namespace depends on XAML or C++/WinRT, so it can be built and tested on any platform.
+    */
+    namespace layout {
+        /**
+         * @brief The unit of a grid length. The values match XAML's `GridUnitType`.
+        */
+        enum class GridUnit : int32_t {
+            Auto = 0,
+            Pixel = 1,
+            Star = 2,
+        };
+
+        /**
+         * @brief A row height or column width, as in XAML's `GridLength`.
+        */
+        struct GridLength {
+            double value{ 1 };
+            GridUnit unit{ GridUnit::Auto };
+
+            static constexpr GridLength Auto() noexcept { return { 1, GridUnit::Auto }; }
+            static constexpr GridLength Pixels(double value) noexcept { return { value, GridUnit::Pixel }; }
+            static constexpr GridLength Star(double value = 1) noexcept { return { value, GridUnit::Star }; }
+
+            constexpr bool operator==(const GridLength& other) const noexcept { return value == other.value && unit == other.unit; }
+            constexpr bool operator!=(const GridLength& other) const noexcept { return !(*this == other); }
+        };
+
+        namespace details {
+            template<typename CharT>
+            constexpr bool is_space(CharT c) noexcept {
+                return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+            }
+
+            template<typename CharT>
+            constexpr std::basic_string_view<CharT> trim(std::basic_string_view<CharT> s) noexcept {
+                while (!s.empty() && is_space(s.front())) s.remove_prefix(1);
+                while (!s.empty() && is_space(s.back())) s.remove_suffix(1);
+                return s;
+            }
+
+            template<typename CharT>
+            constexpr bool iequals_ascii(std::basic_string_view<CharT> s, const char* ascii) noexcept {
+                size_t i = 0;
+                for (; i < s.size() && ascii[i]; i++) {
+                    auto c = s[i];
+                    if (c >= 'A' && c <= 'Z') c = static_cast<CharT>(c + ('a' - 'A'));
+                    if (c != static_cast<CharT>(ascii[i])) return false;
+                }
+                return i == s.size() && !ascii[i];
+            }
+
+            /**
+             * @brief Parses a non-negative decimal number, like `40` or `0.5`.
+             * @details Only numbers whose digits fit in a double's mantissa are handled, which makes the result exact
+             * (the mantissa and the power of ten are both exactly representable, so the division rounds correctly, as `wcstod` would).
+             * Anything else (signs, exponents, very long numbers) yields `std::nullopt`.
+            */
+            template<typename CharT>
+            constexpr std::optional<double> parse_number(std::basic_string_view<CharT> s) noexcept {
+                constexpr uint64_t maxExact = uint64_t{ 1 } << 53;
+                uint64_t mantissa = 0;
+                int fractionDigits = 0;
+                bool dot = false;
+                bool anyDigit = false;
+                for (auto c : s) {
+                    if (c >= '0' && c <= '9') {
+                        if (mantissa > (maxExact - 9) / 10) return std::nullopt;
+                        mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+                        fractionDigits += dot ? 1 : 0;
+                        anyDigit = true;
+                    }
+                    else if (c == '.' && !dot) {
+                        dot = true;
+                    }
+                    else {
+                        return std::nullopt;
+                    }
+                }
+                if (!anyDigit || fractionDigits > 22) return std::nullopt;
+                double scale = 1;
+                for (int i = 0; i < fractionDigits; i++) scale *= 10;
+                return static_cast<double>(mantissa) / scale;
+            }
+        }
+
+        /**
+         * @brief Parses a grid length with the same syntax as XAML: `Auto`, `*`, `N*` or a number of pixels, surrounded by optional whitespace.
+         * @details This is constexpr and allocation-free. It returns `std::nullopt` for input it doesn't handle (e.g. units like `1in`, or exponents),
+         * which callers can hand over to the XAML type converter.\n
+         * Example:\n
+         * @code
+         * static_assert(cppxaml::layout::ParseGridLength(std::string_view("2*")) == cppxaml::layout::GridLength::Star(2));
+         * @endcode
+         * @param s The text to parse.
+         * @return The grid length, or `std::nullopt`.
+        */
+        template<typename CharT>
+        constexpr std::optional<GridLength> ParseGridLength(std::basic_string_view<CharT> s) noexcept {
+            s = details::trim(s);
+            if (details::iequals_ascii(s, "auto")) {
+                return GridLength::Auto();
+            }
+            if (!s.empty() && s.back() == '*') {
+                s.remove_suffix(1);
+                if (s.empty()) {
+                    return GridLength::Star();
+                }
+                if (auto value = details::parse_number(s)) {
+                    return GridLength::Star(*value);
+                }
+                return std::nullopt;
+            }
+            if (auto value = details::parse_number(s)) {
+                return GridLength::Pixels(*value);
+            }
+            return std::nullopt;
+        }
+
+        /**
+         * @brief Calls `f` with each comma-separated token of a list of grid lengths, e.g. `"40, *, Auto"`.
+         * @details An empty list has no tokens. Otherwise every comma separates two tokens, so `"40,"` yields `"40"` and an empty token,
+         * which the parser then rejects.
+         * @param s The list.
+         * @param f Takes a `std::basic_string_view<CharT>` (untrimmed).
+        */
+        template<typename CharT, typename F>
+        constexpr void ForEachGridLengthToken(std::basic_string_view<CharT> s, F&& f) {
+            if (s.empty()) {
+                return;
+            }
+            while (true) {
+                size_t comma = 0;
+                while (comma < s.size() && s[comma] != ',') comma++;
+                f(s.substr(0, comma));
+                if (comma == s.size()) {
+                    break;
+                }
+                s.remove_prefix(comma + 1);
+            }
+        }
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+        /**
+         * @brief Which dimension of a grid a cppxaml::layout::GridSpec defines.
+        */
+        enum class GridAxis {
+            Rows,
+            Columns,
+        };
+
+        /**
+         * @brief A fixed list of row heights or column widths, parsed at compile time. See cppxaml::layout::literals.
+        */
+        template<GridAxis Axis, size_t N>
+        struct GridSpec {
+            std::array<GridLength, N> lengths{};
+
+            static constexpr GridAxis axis() noexcept { return Axis; }
+            static constexpr size_t size() noexcept { return N; }
+            constexpr auto begin() const noexcept { return lengths.begin(); }
+            constexpr auto end() const noexcept { return lengths.end(); }
+        };
+
+        namespace details {
+            template<size_t N>
+            struct fixed_string {
+                char chars[N]{};
+                constexpr fixed_string(const char(&s)[N]) noexcept {
+                    for (size_t i = 0; i < N; i++) chars[i] = s[i];
+                }
+                constexpr std::string_view view() const noexcept { return { chars, N - 1 }; }
+            };
+
+            // Not constexpr: reaching it while parsing a literal makes the literal fail to compile.
+            inline void malformed_grid_length_in_spec() {}
+
+            constexpr size_t count_grid_length_tokens(std::string_view s) {
+                size_t n = 0;
+                ForEachGridLengthToken(s, [&n](std::string_view) { n++; });
+                return n;
+            }
+
+            template<GridAxis Axis, size_t N>
+            constexpr GridSpec<Axis, N> parse_grid_spec(std::string_view s) {
+                GridSpec<Axis, N> spec{};
+                size_t i = 0;
+                ForEachGridLengthToken(s, [&spec, &i](std::string_view token) {
+                    if (auto length = ParseGridLength(token)) {
+                        spec.lengths[i++] = *length;
+                    }
+                    else {
+                        malformed_grid_length_in_spec();
+                    }
+                });
+                return spec;
+            }
+
+            template<GridAxis Axis, fixed_string Spec>
+            constexpr auto make_grid_spec() {
+                constexpr auto spec = parse_grid_spec<Axis, count_grid_length_tokens(Spec.view())>(Spec.view());
+                return spec;
+            }
+        }
+
+        /**
+         * @brief User-defined literals for grid specs, parsed and validated at compile time.
+         * @details The syntax is the same as for the string specs of cppxaml::Grid, except that only what cppxaml::layout::ParseGridLength handles is allowed;
+         * a malformed spec is a compile error. The result is a cppxaml::layout::GridSpec, which holds its lengths in a `std::array`.
+
+         * Example:
+
+         * @code
+         * using namespace cppxaml::layout::literals;
+         * auto grid = cppxaml::Grid("40, *"_rows, "Auto, Auto"_cols, {
+         *     {0, 0, cppxaml::TextBlock(L"first") },
+         *     {1, 1, cppxaml::TextBlock(L"second") },
+         * });
+         * @endcode
+         * Requires C++20.
+        */
+        namespace literals {
+            template<details::fixed_string Spec>
+            constexpr auto operator""_rows() {
+                return details::make_grid_spec<GridAxis::Rows, Spec>();
+            }
+
+            template<details::fixed_string Spec>
+            constexpr auto operator""_cols() {
+                return details::make_grid_spec<GridAxis::Columns, Spec>();
+            }
+        }
+#endif
+
+        static_assert(ParseGridLength(std::string_view("Auto")) == GridLength::Auto());
+        static_assert(ParseGridLength(std::wstring_view(L" auto ")) == GridLength::Auto());
+        static_assert(ParseGridLength(std::string_view("*")) == GridLength::Star());
+        static_assert(ParseGridLength(std::string_view(" 2.5* ")) == GridLength::Star(2.5));
+        static_assert(ParseGridLength(std::string_view("40")) == GridLength::Pixels(40));
+        static_assert(!ParseGridLength(std::string_view("1in")));
+        static_assert(!ParseGridLength(std::string_view("")));
+    }
+}
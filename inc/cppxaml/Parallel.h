@@ -0,0 +1,135 @@
+#pragma once
+#include <cppxaml/utils.h>
+#include <algorithm>
+#include <execution>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+/** @file
+* @author Alexander Sklar
+* @section LICENSE
+ * Copyright (c) Alexander Sklar
+ *
+ * Licensed under the MIT license
+*/
+
+// The parallel overloads of cppxaml::utils::transform and cppxaml::utils::transform_with_index.
+// They live apart from utils.h, so that only their users pay for including <execution>.
+
+namespace cppxaml {
+    namespace details {
+#ifdef WINRT_BASE_H
+        template<typename T>
+        constexpr bool is_winrt_object = std::is_base_of_v<winrt::Windows::Foundation::IUnknown, T>;
+#else
+        template<typename T>
+        constexpr bool is_winrt_object = false;
+#endif
+
+        /**
+         * @brief Produces `count` values in parallel (as permitted by the execution policy) into a pre-sized vector.
+         * @details The vector gets pre-sized without default-constructing the values where that could have side effects:
+         * C++/WinRT types are filled with `nullptr` (default-constructing a runtime class activates a new object), and types whose default constructor
+         * may throw (e.g. cppxaml wrappers, which create their control) or doesn't exist are produced into `std::optional` slots first.
+         * @param policy The execution policy.
+         * @param count The number of values.
+         * @param produce Produces the value at an index; it must be safe to call concurrently under a parallel policy.
+        */
+        template<typename TResult, typename ExecutionPolicy, typename Produce>
+        std::vector<TResult> produce_n(ExecutionPolicy&& policy, size_t count, Produce&& produce) {
+            std::vector<TResult> out;
+            constexpr bool isWinRT = is_winrt_object<TResult>;
+            if constexpr (!std::is_same_v<TResult, bool> && (isWinRT || std::is_nothrow_default_constructible_v<TResult>)) {
+                if constexpr (isWinRT) {
+                    out.assign(count, TResult{ nullptr });
+                }
+                else {
+                    out.resize(count);
+                }
+                std::for_each(std::forward<ExecutionPolicy>(policy), out.begin(), out.end(), [&](TResult& slot) { slot = produce(static_cast<size_t>(&slot - out.data())); });
+            }
+            else {
+                std::vector<std::optional<TResult>> slots(count);
+                std::for_each(std::forward<ExecutionPolicy>(policy), slots.begin(), slots.end(), [&](std::optional<TResult>& slot) { slot.emplace(produce(static_cast<size_t>(&slot - slots.data()))); });
+                out.reserve(count);
+                for (auto& slot : slots) {
+                    out.push_back(std::move(*slot));
+                }
+            }
+            return out;
+        }
+
+        /**
+         * @brief Maps a container in parallel, and returns the results in a `TOutContainer`.
+         * @param map Maps an element and its index.
+        */
+        template<template<typename...> typename TOutContainer, typename TResult, typename ExecutionPolicy, typename TInContainer, typename Map>
+        auto parallel_map(ExecutionPolicy&& policy, TInContainer const& iterable, Map&& map) {
+            using iterator_t = decltype(iterable.cbegin());
+            std::vector<TResult> mapped;
+            if constexpr (std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<iterator_t>::iterator_category>) {
+                const auto begin = iterable.cbegin();
+                mapped = produce_n<TResult>(std::forward<ExecutionPolicy>(policy), static_cast<size_t>(iterable.cend() - begin), [&](size_t i) { return map(*(begin + i), i); });
+            }
+            else {
+                // parallel algorithms need random access to the input, so index the elements first
+                std::vector<iterator_t> elements;
+                for (auto i = iterable.cbegin(); i != iterable.cend(); i++) {
+                    elements.push_back(i);
+                }
+                mapped = produce_n<TResult>(std::forward<ExecutionPolicy>(policy), elements.size(), [&](size_t i) { return map(*elements[i], i); });
+            }
+
+            if constexpr (std::is_same_v<TOutContainer<TResult>, std::vector<TResult>>) {
+                return mapped;
+            }
+            else {
+                TOutContainer<TResult> out{};
+                reserve_for(out, mapped);
+                std::move(mapped.begin(), mapped.end(), std::inserter(out, out.end()));
+                return out;
+            }
+        }
+    }
+
+    namespace utils {
+        /**
+         * @brief Maps each element in a container via a unary operation on each element, using a parallel algorithm.
+         * @details The output is pre-sized rather than grown, and the elements are mapped as per the execution policy (e.g. `std::execution::par`).
+         * With a parallel policy, `unary_op` must be safe to call concurrently; in particular, it must not create XAML objects, which belong to the UI thread.
+         * This makes it suited to computing view-models from large data sets, before building UI out of them.
+         * @tparam TOutContainer The output container type. Defaults to std::vector.
+         * @param policy The execution policy.
+         * @param iterable The container
+         * @param unary_op The lambda for the unary operation; takes the element type of the input container.
+         * @return A container comprised of the mapped elements, in the order of the input.
+        */
+        template<template<typename...> typename TOutContainer = std::vector, typename ExecutionPolicy, typename TInContainer, typename UnaryOp,
+            typename = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+        auto transform(ExecutionPolicy&& policy, TInContainer const& iterable, UnaryOp&& unary_op) {
+            using result_t = std::invoke_result_t<UnaryOp, typename TInContainer::value_type>;
+            return details::parallel_map<TOutContainer, result_t>(std::forward<ExecutionPolicy>(policy), iterable,
+                [&unary_op](const auto& element, size_t) { return unary_op(element); });
+        }
+
+        /**
+         * @brief Maps each element in a container via a unary operation on each element and its index, using a parallel algorithm.
+         * @details See the execution policy overload of cppxaml::utils::transform for the requirements on `unary_op`.
+         * @tparam TOutContainer The output container type. Defaults to std::vector.
+         * @param policy The execution policy.
+         * @param iterable The container
+         * @param unary_op The lambda for the unary operation; takes the element type of the input container, and the index within the container.
+         * @return A container comprised of the mapped elements, in the order of the input.
+        */
+        template<template<typename...> typename TOutContainer = std::vector, typename ExecutionPolicy, typename TInContainer, typename UnaryOp,
+            typename = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+        auto transform_with_index(ExecutionPolicy&& policy, TInContainer const& iterable, UnaryOp&& unary_op) {
+            using difference_t = typename TInContainer::const_iterator::difference_type;
+            using result_t = std::invoke_result_t<UnaryOp, typename TInContainer::value_type, difference_t>;
+            return details::parallel_map<TOutContainer, result_t>(std::forward<ExecutionPolicy>(policy), iterable,
+                [&unary_op](const auto& element, size_t index) { return unary_op(element, static_cast<difference_t>(index)); });
+        }
+    }
+}
@@ -0,0 +1,156 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/** @file
+* @author Alexander Sklar
+* @section LICENSE
+ * Copyright (c) Alexander Sklar
+ *
+ * Licensed under the MIT license
+*/
+
+namespace cppxaml {
+    namespace templates {
+        /**
+         * @brief Keeps detached elements around so that they can be reused instead of creating new ones, up to a capacity.
+         * @details Elements are pooled by key: their type, and optionally the id of the template they were built from (so that elements that need the same setup get reused for each other).
+         * Elements get reset when they are released; an element whose reset fails (e.g. because it is still in a tree) is dropped.\n
+         * The pool isn't thread-safe; use one per UI thread.\n
+         * `Traits` must provide:
+         * - `element_t`: a handle to an element;
+         * - `type_key_t`: identifies a type of element; it must be hashable with `std::hash`, and equality-comparable;
+         * - `static bool reset(element_t&)`: resets a released element so that it can be reused; returns `false` if it can't be.
+         *
+         * Controls.h provides cppxaml::ElementPool, a pool of XAML elements.
+        */
+        template<typename Traits>
+        class RecyclePool {
+        public:
+            using element_t = typename Traits::element_t;
+            using type_key_t = typename Traits::type_key_t;
+            using Reset = std::function<bool(element_t&)>;
+
+            /**
+             * @brief What elements are pooled by.
+            */
+            struct Key {
+                type_key_t type;
+                uint32_t templateId{ 0 };
+
+                bool operator==(const Key& other) const { return templateId == other.templateId && type == other.type; }
+            };
+
+            /**
+             * @brief Counters, to tune the capacity.
+            */
+            struct Statistics {
+                uint64_t hits{};      // acquisitions that reused an element
+                uint64_t misses{};    // acquisitions that created an element
+                uint64_t recycled{};  // released elements that got pooled
+                uint64_t rejected{};  // released elements that got dropped, because their reset failed or the pool was full
+                uint64_t evicted{};   // pooled elements dropped by lowering the capacity
+            };
+
+            /**
+             * @brief Creates a pool.
+             * @param capacity The maximum number of elements the pool holds on to, across all keys.
+             * @param reset Resets released elements; defaults to `Traits::reset`.
+            */
+            explicit RecyclePool(size_t capacity, Reset reset = Traits::reset) : m_capacity(capacity), m_reset(std::move(reset)) {}
+
+            /**
+             * @brief Returns a pooled element for the key if there is one, or a new one otherwise.
+             * @param key The key.
+             * @param create Creates a new element: `element_t()`.
+            */
+            template<typename Create>
+            element_t Acquire(const Key& key, Create&& create) {
+                auto bucket = m_buckets.find(key);
+                if (bucket != m_buckets.end() && !bucket->second.empty()) {
+                    auto element = std::move(bucket->second.back());
+                    bucket->second.pop_back();
+                    m_size--;
+                    m_stats.hits++;
+                    return element;
+                }
+                m_stats.misses++;
+                return create();
+            }
+
+            /**
+             * @brief Resets an element that is no longer used and keeps it for reuse, unless the pool is full.
+             * @param key The key the element was acquired with.
+             * @param element The element. It must not be used after this.
+             * @return Whether the element got pooled.
+            */
+            bool Release(const Key& key, element_t element) {
+                if (m_size >= m_capacity || !m_reset(element)) {
+                    m_stats.rejected++;
+                    return false;
+                }
+                m_buckets[key].push_back(std::move(element));
+                m_size++;
+                m_stats.recycled++;
+                return true;
+            }
+
+            /**
+             * @brief Changes the capacity, dropping pooled elements (evenly across keys) if there are more than that.
+            */
+            void Capacity(size_t capacity) {
+                m_capacity = capacity;
+                while (m_size > m_capacity) {
+                    for (auto& [key, elements] : m_buckets) {
+                        if (!elements.empty() && m_size > m_capacity) {
+                            elements.pop_back();
+                            m_size--;
+                            m_stats.evicted++;
+                        }
+                    }
+                }
+            }
+            size_t Capacity() const noexcept { return m_capacity; }
+
+            /**
+             * @brief Drops all pooled elements.
+            */
+            void Clear() {
+                m_stats.evicted += m_size;
+                m_buckets.clear();
+                m_size = 0;
+            }
+
+            /**
+             * @brief The number of pooled elements.
+            */
+            size_t size() const noexcept { return m_size; }
+            /**
+             * @brief The number of pooled elements for a key.
+            */
+            size_t size(const Key& key) const {
+                auto bucket = m_buckets.find(key);
+                return bucket != m_buckets.end() ? bucket->second.size() : 0;
+            }
+
+            const Statistics& Stats() const noexcept { return m_stats; }
+
+        private:
+            struct KeyHash {
+                size_t operator()(const Key& key) const {
+                    return std::hash<type_key_t>{}(key.type) ^ static_cast<size_t>(key.templateId * 0x9E3779B97F4A7C15ull);
+                }
+            };
+
+            std::unordered_map<Key, std::vector<element_t>, KeyHash> m_buckets;
+            size_t m_size{ 0 };
+            size_t m_capacity;
+            Reset m_reset;
+            Statistics m_stats;
+        };
+    }
+}
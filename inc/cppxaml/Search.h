@@ -0,0 +1,1442 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if !defined(CPPXAML_NO_SIMD)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CPPXAML_SEARCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CPPXAML_SEARCH_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#define CPPXAML_SEARCH_NEON
+#endif
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/** @file
+* @author Alexander Sklar
+* @section LICENSE
+ * Copyright (c) Alexander Sklar
+ *
+ * Licensed under the MIT license
+*/
+
+namespace cppxaml {
+
+    /**
+     * @namespace cppxaml::search
+     * @brief Search primitives that power the default search of `AutoSuggestBox`.\n
+     * Nothing in this namespace depends on XAML or C++/WinRT, so it can be built and benchmarked on any platform.
+    */
+    namespace search {
+        /**
+         * @brief Index of an item within the collection a search structure was built from.
+        */
+        using id_t = uint32_t;
+
+        /**
+         * @brief Case-folds a character. This matches `::tolower` in the default "C" locale, i.e. only ASCII letters are folded.
+        */
+        constexpr wchar_t fold(wchar_t c) noexcept {
+            return (c >= L'A' && c <= L'Z') ? static_cast<wchar_t>(c + (L'a' - L'A')) : c;
+        }
+
+        namespace details {
+            template<bool CaseInsensitive>
+            constexpr wchar_t fold_if(wchar_t c) noexcept {
+                if constexpr (CaseInsensitive) {
+                    return search::fold(c);
+                }
+                else {
+                    return c;
+                }
+            }
+
+            template<bool CaseInsensitive>
+            inline bool equal_n(const wchar_t* a, const wchar_t* b, size_t count) noexcept {
+                for (size_t i = 0; i < count; i++) {
+                    if (fold_if<CaseInsensitive>(a[i]) != fold_if<CaseInsensitive>(b[i])) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            template<bool CaseInsensitive>
+            inline size_t find_scalar(const wchar_t* haystack, size_t haystackSize, const wchar_t* needle, size_t needleSize, size_t from) noexcept {
+                const auto first = fold_if<CaseInsensitive>(needle[0]);
+                for (auto i = from; i + needleSize <= haystackSize; i++) {
+                    if (fold_if<CaseInsensitive>(haystack[i]) == first && equal_n<CaseInsensitive>(haystack + i + 1, needle + 1, needleSize - 1)) {
+                        return i;
+                    }
+                }
+                return std::wstring_view::npos;
+            }
+
+#if defined(CPPXAML_SEARCH_AVX2) || defined(CPPXAML_SEARCH_SSE2) || defined(CPPXAML_SEARCH_NEON)
+            inline unsigned lowest_bit(uint64_t v) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+                unsigned long index;
+#if defined(_M_X64) || defined(_M_ARM64)
+                _BitScanForward64(&index, v);
+#else
+                if (!_BitScanForward(&index, static_cast<unsigned long>(v))) {
+                    _BitScanForward(&index, static_cast<unsigned long>(v >> 32));
+                    index += 32;
+                }
+#endif
+                return index;
+#else
+                return static_cast<unsigned>(__builtin_ctzll(v));
+#endif
+            }
+
+            // Each lanes<> specialization wraps the intrinsics for one instruction set and one width of wchar_t (2 bytes on Windows, 4 elsewhere).
+            // match() returns a bit mask with bits_per_lane bits set for every lane where both comparisons hold.
+            template<size_t CharSize>
+            struct lanes;
+
+#if defined(CPPXAML_SEARCH_AVX2)
+            template<>
+            struct lanes<2> {
+                using vec = __m256i;
+                static constexpr size_t count = 16;
+                static constexpr unsigned bits_per_lane = 2;
+                static vec load(const wchar_t* p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+                static vec broadcast(wchar_t c) noexcept { return _mm256_set1_epi16(static_cast<short>(c)); }
+                static vec fold(vec v) noexcept {
+                    const auto upper = _mm256_and_si256(_mm256_cmpgt_epi16(v, broadcast(L'A' - 1)), _mm256_cmpgt_epi16(broadcast(L'Z' + 1), v));
+                    return _mm256_add_epi16(v, _mm256_and_si256(upper, broadcast(L'a' - L'A')));
+                }
+                static uint64_t match(vec a, vec first, vec b, vec last) noexcept {
+                    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi16(a, first), _mm256_cmpeq_epi16(b, last))));
+                }
+            };
+            template<>
+            struct lanes<4> {
+                using vec = __m256i;
+                static constexpr size_t count = 8;
+                static constexpr unsigned bits_per_lane = 4;
+                static vec load(const wchar_t* p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+                static vec broadcast(wchar_t c) noexcept { return _mm256_set1_epi32(static_cast<int>(c)); }
+                static vec fold(vec v) noexcept {
+                    const auto upper = _mm256_and_si256(_mm256_cmpgt_epi32(v, broadcast(L'A' - 1)), _mm256_cmpgt_epi32(broadcast(L'Z' + 1), v));
+                    return _mm256_add_epi32(v, _mm256_and_si256(upper, broadcast(L'a' - L'A')));
+                }
+                static uint64_t match(vec a, vec first, vec b, vec last) noexcept {
+                    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi32(a, first), _mm256_cmpeq_epi32(b, last))));
+                }
+            };
+#elif defined(CPPXAML_SEARCH_SSE2)
+            template<>
+            struct lanes<2> {
+                using vec = __m128i;
+                static constexpr size_t count = 8;
+                static constexpr unsigned bits_per_lane = 2;
+                static vec load(const wchar_t* p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+                static vec broadcast(wchar_t c) noexcept { return _mm_set1_epi16(static_cast<short>(c)); }
+                static vec fold(vec v) noexcept {
+                    // characters at or above 0x8000 compare as negative, which correctly leaves them alone
+                    const auto upper = _mm_and_si128(_mm_cmpgt_epi16(v, broadcast(L'A' - 1)), _mm_cmpgt_epi16(broadcast(L'Z' + 1), v));
+                    return _mm_add_epi16(v, _mm_and_si128(upper, broadcast(L'a' - L'A')));
+                }
+                static uint64_t match(vec a, vec first, vec b, vec last) noexcept {
+                    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi16(a, first), _mm_cmpeq_epi16(b, last))));
+                }
+            };
+            template<>
+            struct lanes<4> {
+                using vec = __m128i;
+                static constexpr size_t count = 4;
+                static constexpr unsigned bits_per_lane = 4;
+                static vec load(const wchar_t* p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+                static vec broadcast(wchar_t c) noexcept { return _mm_set1_epi32(static_cast<int>(c)); }
+                static vec fold(vec v) noexcept {
+                    const auto upper = _mm_and_si128(_mm_cmpgt_epi32(v, broadcast(L'A' - 1)), _mm_cmpgt_epi32(broadcast(L'Z' + 1), v));
+                    return _mm_add_epi32(v, _mm_and_si128(upper, broadcast(L'a' - L'A')));
+                }
+                static uint64_t match(vec a, vec first, vec b, vec last) noexcept {
+                    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi32(a, first), _mm_cmpeq_epi32(b, last))));
+                }
+            };
+#elif defined(CPPXAML_SEARCH_NEON)
+            template<>
+            struct lanes<2> {
+                using vec = uint16x8_t;
+                static constexpr size_t count = 8;
+                static constexpr unsigned bits_per_lane = 8;
+                static vec load(const wchar_t* p) noexcept { return vld1q_u16(reinterpret_cast<const uint16_t*>(p)); }
+                static vec broadcast(wchar_t c) noexcept { return vdupq_n_u16(static_cast<uint16_t>(c)); }
+                static vec fold(vec v) noexcept {
+                    const auto upper = vandq_u16(vcgeq_u16(v, broadcast(L'A')), vcleq_u16(v, broadcast(L'Z')));
+                    return vaddq_u16(v, vandq_u16(upper, broadcast(L'a' - L'A')));
+                }
+                static uint64_t match(vec a, vec first, vec b, vec last) noexcept {
+                    const auto eq = vandq_u16(vceqq_u16(a, first), vceqq_u16(b, last));
+                    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(eq, 4)), 0);
+                }
+            };
+            template<>
+            struct lanes<4> {
+                using vec = uint32x4_t;
+                static constexpr size_t count = 4;
+                static constexpr unsigned bits_per_lane = 16;
+                static vec load(const wchar_t* p) noexcept { return vld1q_u32(reinterpret_cast<const uint32_t*>(p)); }
+                static vec broadcast(wchar_t c) noexcept { return vdupq_n_u32(static_cast<uint32_t>(c)); }
+                static vec fold(vec v) noexcept {
+                    const auto upper = vandq_u32(vcgeq_u32(v, broadcast(L'A')), vcleq_u32(v, broadcast(L'Z')));
+                    return vaddq_u32(v, vandq_u32(upper, broadcast(L'a' - L'A')));
+                }
+                static uint64_t match(vec a, vec first, vec b, vec last) noexcept {
+                    const auto eq = vandq_u32(vceqq_u32(a, first), vceqq_u32(b, last));
+                    return vget_lane_u64(vreinterpret_u64_u16(vshrn_n_u32(eq, 16)), 0);
+                }
+            };
+#endif
+
+            // Compares a whole register of candidate positions at once against the first and last characters of the needle,
+            // and only verifies the characters in between for the positions where both match.
+            template<bool CaseInsensitive>
+            inline size_t find_vectorized(const wchar_t* haystack, size_t haystackSize, const wchar_t* needle, size_t needleSize) noexcept {
+                using L = lanes<sizeof(wchar_t)>;
+                constexpr uint64_t laneMask = (uint64_t{ 1 } << L::bits_per_lane) - 1;
+                const auto first = L::broadcast(fold_if<CaseInsensitive>(needle[0]));
+                const auto last = L::broadcast(fold_if<CaseInsensitive>(needle[needleSize - 1]));
+                const auto middle = needleSize > 2 ? needleSize - 2 : 0;
+
+                size_t i = 0;
+                for (; i + needleSize - 1 + L::count <= haystackSize; i += L::count) {
+                    auto a = L::load(haystack + i);
+                    auto b = L::load(haystack + i + needleSize - 1);
+                    if constexpr (CaseInsensitive) {
+                        a = L::fold(a);
+                        b = L::fold(b);
+                    }
+                    for (auto mask = L::match(a, first, b, last); mask != 0; ) {
+                        const auto lane = lowest_bit(mask) / L::bits_per_lane;
+                        if (equal_n<CaseInsensitive>(haystack + i + lane + 1, needle + 1, middle)) {
+                            return i + lane;
+                        }
+                        mask &= ~(laneMask << (lane * L::bits_per_lane));
+                    }
+                }
+                return find_scalar<CaseInsensitive>(haystack, haystackSize, needle, needleSize, i);
+            }
+#endif
+
+            template<bool CaseInsensitive>
+            inline size_t find(std::wstring_view haystack, std::wstring_view needle) noexcept {
+                if (needle.empty()) {
+                    return 0;
+                }
+                if (needle.size() > haystack.size()) {
+                    return std::wstring_view::npos;
+                }
+#if defined(CPPXAML_SEARCH_AVX2) || defined(CPPXAML_SEARCH_SSE2) || defined(CPPXAML_SEARCH_NEON)
+                return find_vectorized<CaseInsensitive>(haystack.data(), haystack.size(), needle.data(), needle.size());
+#else
+                return find_scalar<CaseInsensitive>(haystack.data(), haystack.size(), needle.data(), needle.size(), 0);
+#endif
+            }
+        }
+
+        /**
+         * @brief Finds the first occurrence of a string within another, optionally ignoring case (as per cppxaml::search::fold).
+         * @details This doesn't allocate, and uses SSE2, AVX2 or NEON when available. Define `CPPXAML_NO_SIMD` to force the scalar implementation.
+         * @param haystack The string to search in.
+         * @param needle The string to search for.
+         * @param caseInsensitive Whether to ignore case.
+         * @return The position of the first occurrence, or `std::wstring_view::npos`.
+        */
+        inline size_t find(std::wstring_view haystack, std::wstring_view needle, bool caseInsensitive = false) noexcept {
+            return caseInsensitive ? details::find<true>(haystack, needle) : details::find<false>(haystack, needle);
+        }
+
+        /**
+         * @brief Returns whether a string contains another, optionally ignoring case. See cppxaml::search::find.
+        */
+        inline bool contains(std::wstring_view haystack, std::wstring_view needle, bool caseInsensitive = false) noexcept {
+            return search::find(haystack, needle, caseInsensitive) != std::wstring_view::npos;
+        }
+
+        /**
+         * @brief Returns whether two strings are equal, optionally ignoring case.
+        */
+        inline bool equals(std::wstring_view a, std::wstring_view b, bool caseInsensitive = false) noexcept {
+            if (a.size() != b.size()) {
+                return false;
+            }
+            return caseInsensitive ? details::equal_n<true>(a.data(), b.data(), a.size()) : a == b;
+        }
+
+        /**
+         * @brief Case-folded, contiguous storage for a collection of strings.
+         * @details Rather than keeping one heap-allocated string per item, the items are copied once into a single character buffer,
+         * each followed by a null terminator, with a separate table holding where each item starts (i.e. a struct of arrays rather than an array of strings).
+         * When the catalog is case-insensitive, a second buffer with the same layout holds the folded items, which is what matchers scan;
+         * it is omitted whenever folding doesn't change any item.\n
+         * The buffers can also live outside of the catalog, e.g. in a memory-mapped catalog file (see cppxaml::search::LoadCatalogFile).
+        */
+        class Catalog {
+        public:
+            Catalog() = default;
+
+            /**
+             * @brief Copies and folds the items into the catalog.
+             * @tparam TItems A collection of strings, e.g. `std::vector<std::wstring>`. Each element must be convertible to `std::wstring_view`.
+             * @param items The items. Item ids are their position in the collection.
+             * @param caseInsensitive Whether items (and queries, see Catalog::Fold) should be case-folded.
+            */
+            template<typename TItems>
+            Catalog(const TItems& items, bool caseInsensitive) : m_caseInsensitive(caseInsensitive) {
+                auto buffers = std::make_shared<Buffers>();
+                size_t count = 0;
+                size_t length = 0;
+                for (const auto& i : items) {
+                    length += std::wstring_view(i).size() + 1;
+                    count++;
+                }
+                CheckTextLength(length);
+                buffers->offsets.reserve(count + 1);
+                buffers->original.reserve(length);
+
+                for (const auto& i : items) {
+                    std::wstring_view item(i);
+                    buffers->offsets.push_back(static_cast<uint32_t>(buffers->original.size()));
+                    buffers->original.append(item);
+                    // The terminator keeps substring matches from running into the next item, and sorts before any other character.
+                    buffers->original.push_back(L'\0');
+                }
+                buffers->offsets.push_back(static_cast<uint32_t>(buffers->original.size()));
+
+                if (caseInsensitive) {
+                    auto changed = std::find_if(buffers->original.begin(), buffers->original.end(), [](wchar_t c) { return search::fold(c) != c; });
+                    if (changed != buffers->original.end()) {
+                        buffers->folded.reserve(buffers->original.size());
+                        std::transform(buffers->original.begin(), buffers->original.end(), std::back_inserter(buffers->folded), search::fold);
+                    }
+                }
+
+                m_original = buffers->original.data();
+                m_folded = buffers->folded.empty() ? m_original : buffers->folded.data();
+                m_offsets = buffers->offsets.data();
+                m_size = count;
+                m_sizeInBytes = (buffers->original.capacity() + buffers->folded.capacity()) * sizeof(wchar_t) + buffers->offsets.capacity() * sizeof(uint32_t);
+                m_storage = std::move(buffers);
+            }
+
+            /**
+             * @brief Creates a catalog holding the items of one catalog followed by those of another. Ids of the first catalog's items are unchanged.
+             * @details The result lives in append-only buffers, which it shares with the catalogs later appended to it:
+             * when the first catalog already lives in such buffers, has the most items in them, and they have room to spare,
+             * the second catalog's items are written in place after the first's, so appending only costs the second catalog's length.
+             * Otherwise both catalogs are copied into new buffers that leave room to grow, so that a sequence of appends costs amortized linear time overall.
+             * Either way, the first catalog is left unchanged.
+             * @param first The first catalog.
+             * @param second The second catalog; it must have the same case mode as the first.
+            */
+            Catalog(const Catalog& first, const Catalog& second) : m_caseInsensitive(first.CaseInsensitive()) {
+                const auto firstLength = first.TextLength();
+                const auto length = firstLength + second.TextLength();
+                const auto count = first.size() + second.size();
+                CheckTextLength(length);
+                const bool folded = first.HasFoldedText() || second.HasFoldedText();
+
+                auto arena = first.m_arena;
+                if (!arena || !arena->TryClaim(first.size(), count, length, folded)) {
+                    // grow geometrically
+                    arena = std::make_shared<Arena>((std::min)((std::max)(length, 2 * firstLength), MaxTextLength), (std::max)(count, 2 * first.size()), folded, count);
+                    std::copy_n(first.OriginalText(), firstLength, arena->original.get());
+                    if (folded) {
+                        std::copy_n(first.FoldedText(), firstLength, arena->folded.get());
+                    }
+                    std::copy_n(first.Offsets(), first.size(), arena->offsets.get());
+                    arena->offsets[first.size()] = static_cast<uint32_t>(firstLength);
+                }
+
+                // Only write past the first catalog's items: other catalogs may be reading those.
+                std::copy_n(second.OriginalText(), second.TextLength(), arena->original.get() + firstLength);
+                if (arena->folded) {
+                    std::copy_n(second.FoldedText(), second.TextLength(), arena->folded.get() + firstLength);
+                }
+                for (id_t id = 1; id <= second.size(); id++) {
+                    arena->offsets[first.size() + id] = static_cast<uint32_t>(firstLength + second.Offsets()[id]);
+                }
+
+                m_original = arena->original.get();
+                m_folded = arena->folded ? arena->folded.get() : m_original;
+                m_offsets = arena->offsets.get();
+                m_size = count;
+                m_sizeInBytes = (arena->folded ? 2 : 1) * arena->textCapacity * sizeof(wchar_t) + (arena->countCapacity + 1) * sizeof(uint32_t);
+                m_storage = arena;
+                m_arena = std::move(arena);
+            }
+
+            /**
+             * @brief Creates a catalog over buffers it doesn't own, laid out as described above.
+             * @param storage Keeps the buffers alive for as long as the catalog (or a copy of it) exists.
+             * @param original Every item, each followed by a null terminator.
+             * @param folded The folded items, with the same layout, or `nullptr` if folding doesn't change any item.
+             * @param offsets Where each item starts within `original`, plus the total length; i.e. `count + 1` entries.
+             * @param count The number of items.
+             * @param caseInsensitive Whether the items were case-folded.
+            */
+            Catalog(std::shared_ptr<const void> storage, const wchar_t* original, const wchar_t* folded, const uint32_t* offsets, size_t count, bool caseInsensitive) :
+                m_caseInsensitive(caseInsensitive),
+                m_storage(std::move(storage)),
+                m_original(original),
+                m_folded(folded ? folded : original),
+                m_offsets(offsets),
+                m_size(count),
+                m_sizeInBytes(0) {}
+
+            /**
+             * @brief Whether the catalog was built case-insensitively.
+            */
+            bool CaseInsensitive() const noexcept { return m_caseInsensitive; }
+
+            /**
+             * @brief The number of items in the catalog.
+            */
+            size_t size() const noexcept { return m_size; }
+
+            /**
+             * @brief Returns an item as it was added to the catalog.
+            */
+            std::wstring_view Item(id_t id) const noexcept {
+                return { m_original + m_offsets[id], m_offsets[id + 1] - m_offsets[id] - 1 };
+            }
+
+            /**
+             * @brief Returns an item case-folded (when the catalog is case-insensitive).
+            */
+            std::wstring_view Folded(id_t id) const noexcept {
+                return { m_folded + m_offsets[id], m_offsets[id + 1] - m_offsets[id] - 1 };
+            }
+
+            /**
+             * @brief The original buffer: every item, each followed by a null terminator.
+            */
+            const wchar_t* OriginalText() const noexcept { return m_original; }
+
+            /**
+             * @brief The folded buffer: every item, each followed by a null terminator.
+            */
+            const wchar_t* FoldedText() const noexcept { return m_folded; }
+
+            /**
+             * @brief Whether the folded buffer differs from the original one.
+            */
+            bool HasFoldedText() const noexcept { return m_folded != m_original; }
+
+            /**
+             * @brief Where each item starts in the buffers, plus the total length (i.e. `size() + 1` entries).
+            */
+            const uint32_t* Offsets() const noexcept { return m_offsets; }
+
+            /**
+             * @brief The length of the folded buffer, including terminators.
+            */
+            size_t TextLength() const noexcept { return m_size == 0 ? 0 : m_offsets[m_size]; }
+
+            /**
+             * @brief Returns the id of the item that spans a position in the text.
+            */
+            id_t Owner(uint32_t position) const noexcept {
+                return static_cast<id_t>(std::upper_bound(m_offsets, m_offsets + m_size + 1, position) - m_offsets - 1);
+            }
+
+            /**
+             * @brief Folds a query the same way the items in the catalog were folded.
+            */
+            std::wstring Fold(std::wstring_view query) const {
+                std::wstring folded(query);
+                if (m_caseInsensitive) {
+                    std::transform(folded.begin(), folded.end(), folded.begin(), search::fold);
+                }
+                return folded;
+            }
+
+            /**
+             * @brief The number of bytes of heap memory the catalog's buffers use. Buffers the catalog doesn't own (e.g. mapped from a file) aren't counted.
+            */
+            size_t SizeInBytes() const noexcept {
+                return m_sizeInBytes;
+            }
+
+            /**
+             * @brief The maximum length of a catalog's text, including terminators: positions in the text are 32-bit.
+            */
+            static constexpr size_t MaxTextLength = (std::numeric_limits<uint32_t>::max)();
+
+        private:
+            static void CheckTextLength(size_t length) {
+                if (length > MaxTextLength) {
+                    throw std::length_error("The catalog's text is too long to be indexed with 32-bit positions");
+                }
+            }
+
+            struct Buffers {
+                std::wstring original;
+                std::wstring folded;
+                std::vector<uint32_t> offsets;
+            };
+
+            // Append-only buffers, shared by the catalogs built by appending to one another.
+            // Items are never rewritten once a catalog covers them; `count` is how many items have been claimed by a catalog so far.
+            struct Arena {
+                Arena(size_t textCapacity, size_t countCapacity, bool withFolded, size_t claimed) :
+                    original(std::make_unique<wchar_t[]>(textCapacity)),
+                    folded(withFolded ? std::make_unique<wchar_t[]>(textCapacity) : nullptr),
+                    offsets(std::make_unique<uint32_t[]>(countCapacity + 1)),
+                    textCapacity(textCapacity),
+                    countCapacity(countCapacity),
+                    count(claimed) {}
+
+                // Reserves the items past `from` for the catalog being built; fails if another catalog already did, or if they don't fit.
+                bool TryClaim(size_t from, size_t to, size_t length, bool withFolded) noexcept {
+                    if (to > countCapacity || length > textCapacity || (withFolded && !folded)) {
+                        return false;
+                    }
+                    return count.compare_exchange_strong(from, to, std::memory_order_acq_rel);
+                }
+
+                const std::unique_ptr<wchar_t[]> original;
+                const std::unique_ptr<wchar_t[]> folded;
+                const std::unique_ptr<uint32_t[]> offsets;
+                const size_t textCapacity;
+                const size_t countCapacity;
+                std::atomic<size_t> count;
+            };
+
+            bool m_caseInsensitive{ false };
+            // Keeps the buffers below alive; copies of the catalog share them.
+            std::shared_ptr<const void> m_storage;
+            // Set when the buffers are an Arena, which catalogs appended to this one may write to.
+            std::shared_ptr<Arena> m_arena;
+            const wchar_t* m_original{};
+            const wchar_t* m_folded{};
+            const uint32_t* m_offsets{};
+            size_t m_size{};
+            size_t m_sizeInBytes{};
+        };
+
+        namespace details {
+            constexpr bool is_ascii_alnum(wchar_t c) noexcept {
+                return (c >= L'a' && c <= L'z') || (c >= L'A' && c <= L'Z') || (c >= L'0' && c <= L'9');
+            }
+
+            /**
+             * @brief Whether a word starts at a position: at the start of the item, after a separator (space, punctuation), or at a camelCase hump.
+             * @param item The original (unfolded) item, since humps are only visible there.
+            */
+            inline bool is_word_start(std::wstring_view item, size_t pos) noexcept {
+                if (pos == 0) {
+                    return true;
+                }
+                const auto previous = item[pos - 1];
+                const auto current = item[pos];
+                if (previous < 0x80 && !is_ascii_alnum(previous)) {
+                    return true;
+                }
+                return previous >= L'a' && previous <= L'z' && current >= L'A' && current <= L'Z';
+            }
+
+            // Substring matches score in [substringScore - 2 * maxPenalty, substringScore + prefixBonus + exactBonus],
+            // and subsequence matches in [1, maxFuzzyScore], so a substring match always outranks a subsequence match.
+            constexpr int substringScore = 10000;
+            constexpr int prefixBonus = 300;
+            constexpr int wordBonus = 150;
+            constexpr int exactBonus = 200;
+            constexpr int maxPenalty = 64;
+            constexpr int fuzzyCharScore = 16;
+            constexpr int fuzzyWordBonus = 8;
+            constexpr int fuzzyConsecutiveBonus = 4;
+            constexpr int maxFuzzyScore = 5000;
+        }
+
+        /**
+         * @brief Scores how well an item matches a query, for ranked search.
+         * @details An item containing the query scores highest, with bonuses when it starts with the query, when the query starts a word in the item
+         * (after a separator or at a camelCase hump), and when the item is exactly the query; earlier occurrences and shorter items score higher.
+         * Otherwise, an item containing the query's characters in order (e.g. "tnr" in "Times New Roman") gets a lower, fuzzy score,
+         * with bonuses for characters that start words or follow the previous match, and a penalty for gaps.
+         * @param item The item as it was added to the catalog.
+         * @param folded The folded item; it must have the same length as `item`.
+         * @param query The folded query.
+         * @return The score, or 0 if the item doesn't match the query at all.
+        */
+        inline int Score(std::wstring_view item, std::wstring_view folded, std::wstring_view query) noexcept {
+            const auto lengthPenalty = static_cast<int>(std::min<size_t>(folded.size() - std::min<size_t>(folded.size(), query.size()), details::maxPenalty));
+            const auto first = search::find(folded, query);
+            if (first != std::wstring_view::npos) {
+                // prefer an occurrence that starts a word over the first one
+                auto at = first;
+                while (at != std::wstring_view::npos && !details::is_word_start(item, at)) {
+                    const auto next = search::find(folded.substr(at + 1), query);
+                    at = next == std::wstring_view::npos ? next : at + 1 + next;
+                }
+                int score = details::substringScore - lengthPenalty;
+                if (at == 0) {
+                    score += details::prefixBonus;
+                }
+                else if (at != std::wstring_view::npos) {
+                    score += details::wordBonus;
+                }
+                if (folded.size() == query.size()) {
+                    score += details::exactBonus;
+                }
+                return score - static_cast<int>(std::min<size_t>(at != std::wstring_view::npos ? at : first, details::maxPenalty));
+            }
+
+            int score = 0;
+            size_t pos = 0;
+            size_t last = std::wstring_view::npos;
+            for (auto c : query) {
+                while (pos < folded.size() && folded[pos] != c) {
+                    pos++;
+                }
+                if (pos == folded.size()) {
+                    return 0;
+                }
+                score += details::fuzzyCharScore;
+                if (details::is_word_start(item, pos)) {
+                    score += details::fuzzyWordBonus;
+                }
+                if (last != std::wstring_view::npos) {
+                    score += pos == last + 1 ? details::fuzzyConsecutiveBonus : -static_cast<int>(std::min<size_t>(pos - last - 1, details::maxPenalty));
+                }
+                last = pos++;
+            }
+            return std::clamp(score - lengthPenalty, 1, details::maxFuzzyScore);
+        }
+
+        /**
+         * @brief Ranks the items of a catalog against a query, and returns the best ones.
+         * @details Items containing the query are scored first; since they always outrank fuzzy matches (see cppxaml::search::Score),
+         * the fuzzy candidates are only scored when there are fewer than `maxResults` of them.
+         * The best results are then picked with a partial selection (`std::nth_element`), and only those get sorted.
+         * @param catalog The catalog.
+         * @param query The folded query.
+         * @param substringMatches The ids of the items that contain the query, in ascending order (e.g. from SubstringIndex::FindFolded or IncrementalSearch::FindFolded).
+         * @param fuzzyCandidates The ids of the items that may match the query as a subsequence, in ascending order (e.g. from SubstringIndex::FuzzyCandidates).
+         * It may include substring matches, which are skipped.
+         * @param maxResults The maximum number of results, or 0 for no limit.
+         * @return The ids of the best matches, best first. Ties are kept in catalog order.
+        */
+        inline std::vector<id_t> Rank(const Catalog& catalog, std::wstring_view query, const std::vector<id_t>& substringMatches, const std::vector<id_t>& fuzzyCandidates, size_t maxResults) {
+            query = query.substr(0, query.find(L'\0'));
+            const auto limit = maxResults == 0 ? substringMatches.size() : std::min<size_t>(maxResults, substringMatches.size());
+            if (query.empty()) {
+                return std::vector<id_t>(substringMatches.begin(), substringMatches.begin() + limit);
+            }
+
+            struct Scored {
+                int score;
+                id_t id;
+            };
+            std::vector<Scored> scored;
+            scored.reserve(substringMatches.size());
+            for (auto id : substringMatches) {
+                scored.push_back({ search::Score(catalog.Item(id), catalog.Folded(id), query), id });
+            }
+            if (maxResults == 0 || scored.size() < maxResults) {
+                auto next = substringMatches.begin();
+                for (auto id : fuzzyCandidates) {
+                    while (next != substringMatches.end() && *next < id) {
+                        next++;
+                    }
+                    if (next != substringMatches.end() && *next == id) {
+                        continue;
+                    }
+                    if (auto score = search::Score(catalog.Item(id), catalog.Folded(id), query)) {
+                        scored.push_back({ score, id });
+                    }
+                }
+            }
+
+            auto better = [](const Scored& a, const Scored& b) { return a.score != b.score ? a.score > b.score : a.id < b.id; };
+            if (maxResults != 0 && scored.size() > maxResults) {
+                std::nth_element(scored.begin(), scored.begin() + maxResults, scored.end(), better);
+                scored.resize(maxResults);
+            }
+            std::sort(scored.begin(), scored.end(), better);
+
+            std::vector<id_t> ids(scored.size());
+            std::transform(scored.begin(), scored.end(), ids.begin(), [](const Scored& s) { return s.id; });
+            return ids;
+        }
+
+        /**
+         * @brief Substring index over a Catalog.
+         * @details A suffix array is built over the catalog's folded text.
+         * Finding the items that contain a query then costs a binary search over the suffix array plus the number of occurrences,
+         * instead of a scan over every item.\n
+         * An index built by SubstringIndex::Append has one suffix array (segment) per appended chunk, each covering its own part of the text,
+         * and a query is looked up in each of them.\n
+         * Example:\n
+         * @code
+         * auto index = cppxaml::search::SubstringIndex(std::vector<std::wstring>{ L"Arial", L"Segoe UI", L"Calibri" }, true);
+         * auto ids = index.Find(L"ri"); // { 0, 2 }
+         * @endcode
+        */
+        class SubstringIndex {
+        public:
+            /**
+             * @brief A suffix array over part of the catalog's folded text.
+            */
+            struct Segment {
+                /**
+                 * @brief Keeps the suffix array alive, whether it was built in memory or mapped from a file.
+                */
+                std::shared_ptr<const void> storage;
+                /**
+                 * @brief The position (relative to Segment::base) of every non-terminator character in the segment's text, sorted by the suffix that starts there.
+                */
+                const uint32_t* suffixes{};
+                size_t count{};
+                /**
+                 * @brief Where the segment's text starts in the catalog's folded text.
+                */
+                uint32_t base{};
+            };
+
+            SubstringIndex() : m_catalog(std::make_shared<const search::Catalog>()) {}
+
+            /**
+             * @brief Builds the index over a catalog.
+             * @param catalog The catalog to index.
+            */
+            explicit SubstringIndex(std::shared_ptr<const search::Catalog> catalog) : m_catalog(std::move(catalog)) {
+                const auto text = m_catalog->FoldedText();
+                const auto length = static_cast<uint32_t>(m_catalog->TextLength());
+                auto suffixes = std::make_shared<std::vector<uint32_t>>();
+                suffixes->reserve(length - m_catalog->size());
+                for (uint32_t pos = 0; pos < length; pos++) {
+                    if (text[pos] != L'\0') {
+                        suffixes->push_back(pos);
+                    }
+                }
+                std::sort(suffixes->begin(), suffixes->end(), [text](uint32_t a, uint32_t b) {
+                    while (text[a] == text[b] && text[a] != L'\0') {
+                        a++;
+                        b++;
+                    }
+                    return text[a] < text[b];
+                    });
+                const auto data = suffixes->data();
+                const auto count = suffixes->size();
+                m_segments.push_back({ std::move(suffixes), data, count, 0 });
+            }
+
+            /**
+             * @brief Creates an index over a catalog from a prebuilt suffix array, e.g. one mapped from a catalog file.
+             * @param catalog The indexed catalog.
+             * @param storage Keeps the suffix array alive for as long as the index exists.
+             * @param suffixes The position of every non-terminator character of the catalog's folded text, sorted by the suffix that starts there.
+             * @param count The number of entries in `suffixes`.
+            */
+            SubstringIndex(std::shared_ptr<const search::Catalog> catalog, std::shared_ptr<const void> storage, const uint32_t* suffixes, size_t count) :
+                m_catalog(std::move(catalog)), m_segments{ Segment{ std::move(storage), suffixes, count, 0 } } {}
+
+            /**
+             * @brief Creates an index over a catalog from prebuilt segments, which together must cover all of the catalog's text.
+            */
+            SubstringIndex(std::shared_ptr<const search::Catalog> catalog, std::vector<Segment> segments) :
+                m_catalog(std::move(catalog)), m_segments(std::move(segments)) {}
+
+            /**
+             * @brief Builds a catalog from a collection of strings, and indexes it.
+             * @tparam TItems A collection of strings, see Catalog::Catalog.
+             * @param items The items to index. Item ids are their position in the collection.
+             * @param caseInsensitive Whether items and queries should be case-folded.
+            */
+            template<typename TItems>
+            SubstringIndex(const TItems& items, bool caseInsensitive) : SubstringIndex(std::make_shared<const search::Catalog>(items, caseInsensitive)) {}
+
+            /**
+             * @brief Returns a new index with more items appended; this index is left unchanged.
+             * @details Only the new items get sorted, into a new segment; the existing segments are shared with this index.
+             * The new items' text is usually written in place after this index's (see Catalog::Catalog(const Catalog&, const Catalog&)),
+             * so appending a chunk costs time proportional to the chunk, not to the whole catalog.
+             * Existing items keep their ids, and the new items' ids follow them.
+             * @tparam TItems A collection of strings, see Catalog::Catalog.
+             * @param items The items to append.
+             * @return The new index.
+            */
+            template<typename TItems>
+            std::shared_ptr<const SubstringIndex> Append(const TItems& items) const {
+                const SubstringIndex chunk(items, CaseInsensitive());
+                auto catalog = std::make_shared<const search::Catalog>(*m_catalog, chunk.Items());
+                std::vector<Segment> segments;
+                std::copy_if(m_segments.begin(), m_segments.end(), std::back_inserter(segments), [](const Segment& segment) { return segment.count != 0; });
+                for (auto segment : chunk.m_segments) {
+                    segment.base += static_cast<uint32_t>(m_catalog->TextLength());
+                    segments.push_back(std::move(segment));
+                }
+                return std::make_shared<const SubstringIndex>(std::move(catalog), std::move(segments));
+            }
+
+            /**
+             * @brief The indexed items.
+            */
+            const search::Catalog& Items() const noexcept { return *m_catalog; }
+
+            /**
+             * @brief The indexed items, as a shared pointer.
+            */
+            const std::shared_ptr<const search::Catalog>& ItemsPtr() const noexcept { return m_catalog; }
+
+            /**
+             * @brief The suffix arrays.
+            */
+            const std::vector<Segment>& Segments() const noexcept { return m_segments; }
+
+            /**
+             * @brief Whether the index was built case-insensitively.
+            */
+            bool CaseInsensitive() const noexcept { return m_catalog->CaseInsensitive(); }
+
+            /**
+             * @brief The number of items in the index.
+            */
+            size_t size() const noexcept { return m_catalog->size(); }
+
+            /**
+             * @brief Folds a query the same way the items in the index were folded.
+            */
+            std::wstring Fold(std::wstring_view query) const {
+                return m_catalog->Fold(query);
+            }
+
+            /**
+             * @brief Finds the items that contain the query.
+             * @param query The query; it gets folded as per SubstringIndex::Fold.
+             * @return The ids of the matching items, in ascending order. An empty query matches every item.
+            */
+            std::vector<id_t> Find(std::wstring_view query) const {
+                return FindFolded(Fold(query));
+            }
+
+            /**
+             * @brief Finds the items that contain an already folded query.
+             * @param query The folded query.
+             * @return The ids of the matching items, in ascending order. An empty query matches every item.
+            */
+            std::vector<id_t> FindFolded(std::wstring_view query) const {
+                std::vector<id_t> ids;
+                // items can't contain the terminator, so neither can a match
+                query = query.substr(0, query.find(L'\0'));
+                if (query.empty()) {
+                    ids.resize(size());
+                    for (id_t i = 0; i < ids.size(); i++) {
+                        ids[i] = i;
+                    }
+                    return ids;
+                }
+                if (query.size() <= LinearScanMaxQueryLength) {
+                    return FindByScanning(query);
+                }
+
+                for (const auto& segment : m_segments) {
+                    const auto [first, last] = Occurrences(segment, query);
+                    ids.reserve(ids.size() + (last - first));
+                    for (auto i = first; i != last; i++) {
+                        ids.push_back(m_catalog->Owner(segment.base + *i));
+                    }
+                }
+                std::sort(ids.begin(), ids.end());
+                ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+                return ids;
+            }
+
+            /**
+             * @brief Finds the items that may match an already folded query as a subsequence, for ranked search.
+             * @details An item can only match if it contains every character of the query, so the candidates are the items that contain its rarest character.
+             * Counting the occurrences of a character is a binary search in each suffix array, and only the rarest character's occurrences are enumerated,
+             * so the cost doesn't grow with the size of the catalog. When even the rarest character occurs more than `budget` times,
+             * only the items of its first `budget` occurrences (in suffix order) are returned, and some fuzzy matches may be missed.
+             * @param query The folded query.
+             * @param budget The maximum number of occurrences to enumerate, and so of candidates.
+             * @return The ids of the candidates, in ascending order.
+            */
+            std::vector<id_t> FuzzyCandidates(std::wstring_view query, size_t budget = DefaultFuzzyBudget) const {
+                std::vector<id_t> ids;
+                query = query.substr(0, query.find(L'\0'));
+                if (query.empty()) {
+                    return ids;
+                }
+                auto rarest = query.front();
+                size_t fewest = (std::numeric_limits<size_t>::max)();
+                for (auto c : query) {
+                    size_t count = 0;
+                    for (const auto& segment : m_segments) {
+                        const auto [first, last] = Occurrences(segment, std::wstring_view(&c, 1));
+                        count += last - first;
+                    }
+                    if (count < fewest) {
+                        rarest = c;
+                        fewest = count;
+                    }
+                }
+
+                ids.reserve((std::min)(fewest, budget));
+                for (const auto& segment : m_segments) {
+                    auto [first, last] = Occurrences(segment, std::wstring_view(&rarest, 1));
+                    for (auto i = first; i != last && ids.size() < budget; i++) {
+                        ids.push_back(m_catalog->Owner(segment.base + *i));
+                    }
+                }
+                std::sort(ids.begin(), ids.end());
+                ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+                return ids;
+            }
+
+            /**
+             * @brief Ranks the items that contain an already folded query, plus fuzzy matches when there aren't enough of those. See cppxaml::search::Rank.
+             * @param query The folded query.
+             * @param substringMatches The ids of the items that contain the query, in ascending order (e.g. from SubstringIndex::FindFolded or IncrementalSearch::FindFolded).
+             * @param maxResults The maximum number of results, or 0 for no limit.
+             * @param fuzzyBudget The maximum number of fuzzy candidates to score, see SubstringIndex::FuzzyCandidates.
+             * @return The ids of the best matches, best first.
+            */
+            std::vector<id_t> RankFolded(std::wstring_view query, const std::vector<id_t>& substringMatches, size_t maxResults, size_t fuzzyBudget = DefaultFuzzyBudget) const {
+                // substring matches always outrank fuzzy ones, so the candidates are only needed when there aren't enough of them
+                const bool needFuzzy = maxResults == 0 || substringMatches.size() < maxResults;
+                return search::Rank(*m_catalog, query, substringMatches, needFuzzy ? FuzzyCandidates(query, fuzzyBudget) : std::vector<id_t>{}, maxResults);
+            }
+
+            /**
+             * @brief Finds the items that best match the query, including fuzzy matches. See cppxaml::search::Rank.
+             * @param query The query; it gets folded as per SubstringIndex::Fold.
+             * @param maxResults The maximum number of results, or 0 for no limit.
+             * @param fuzzyBudget The maximum number of fuzzy candidates to score, see SubstringIndex::FuzzyCandidates.
+             * @return The ids of the best matches, best first.
+            */
+            std::vector<id_t> FindRanked(std::wstring_view query, size_t maxResults, size_t fuzzyBudget = DefaultFuzzyBudget) const {
+                const auto folded = Fold(query);
+                return RankFolded(folded, FindFolded(folded), maxResults, fuzzyBudget);
+            }
+
+            /**
+             * @brief Queries up to this long are found by scanning the text rather than through the suffix arrays:
+             * short queries occur so often that enumerating and sorting their occurrences costs more than a (vectorized) scan.
+            */
+            static constexpr size_t LinearScanMaxQueryLength = 1;
+
+            /**
+             * @brief The default number of fuzzy candidates a ranked search scores, which bounds its cost on each keystroke.
+            */
+            static constexpr size_t DefaultFuzzyBudget = 4096;
+
+        private:
+            // the range of a segment's suffix array whose suffixes start with the query
+            std::pair<const uint32_t*, const uint32_t*> Occurrences(const Segment& segment, std::wstring_view query) const {
+                const auto text = m_catalog->FoldedText() + segment.base;
+                // compares the first query.size() characters of a suffix against the query
+                auto compare = [text, query](uint32_t pos) {
+                    for (auto c : query) {
+                        if (text[pos] != c) {
+                            return text[pos] < c ? -1 : 1;
+                        }
+                        pos++;
+                    }
+                    return 0;
+                };
+                const auto end = segment.suffixes + segment.count;
+                auto first = std::partition_point(segment.suffixes, end, [&](uint32_t pos) { return compare(pos) < 0; });
+                auto last = std::partition_point(first, end, [&](uint32_t pos) { return compare(pos) == 0; });
+                return { first, last };
+            }
+
+            // finds the first occurrence in each item, and skips to the next item from there
+            std::vector<id_t> FindByScanning(std::wstring_view query) const {
+                std::vector<id_t> ids;
+                const std::wstring_view text(m_catalog->FoldedText(), m_catalog->TextLength());
+                const auto offsets = m_catalog->Offsets();
+                id_t id = 0;
+                for (auto pos = search::find(text, query); pos != std::wstring_view::npos;) {
+                    while (offsets[id + 1] <= pos) {
+                        id++;
+                    }
+                    ids.push_back(id);
+                    const size_t next = offsets[id + 1];
+                    const auto found = search::find(text.substr(next), query);
+                    pos = found == std::wstring_view::npos ? found : next + found;
+                }
+                return ids;
+            }
+
+            std::shared_ptr<const search::Catalog> m_catalog;
+            std::vector<Segment> m_segments;
+        };
+
+        /**
+         * @brief Caches the matches of recent queries so that narrowing a query only filters the previous matches.
+         * @details The cache is a stack of levels, where each level's query contains the one below it.
+         * When the new query contains the query at the top of the stack (e.g. the user typed "aria" after "ari"), only that level's matches are filtered,
+         * so the cost is proportional to the number of matches rather than to the number of items.
+         * When the user deletes characters, the levels whose query is no longer contained in the new query are dropped, and a level with the same query is reused as-is.\n
+         * An IncrementalSearch isn't thread-safe; it is meant to be used by a single search handler.
+        */
+        class IncrementalSearch {
+        public:
+            /**
+             * @brief Creates an incremental search over an index.
+             * @param index The index to search.
+             * @param maxLevels The maximum number of cached queries.
+            */
+            IncrementalSearch(std::shared_ptr<const SubstringIndex> index, size_t maxLevels = 32) : m_index(std::move(index)), m_maxLevels(maxLevels) {}
+
+            /**
+             * @brief The index being searched.
+            */
+            const SubstringIndex& Index() const noexcept { return *m_index; }
+
+            /**
+             * @brief Finds the items that contain an already folded query.
+             * @param query The folded query (see SubstringIndex::Fold).
+             * @return The ids of the matching items, in ascending order. The result is only valid until the next call.
+            */
+            const std::vector<id_t>& FindFolded(std::wstring_view query) {
+                while (!m_levels.empty() && query.find(m_levels.back().query) == std::wstring_view::npos) {
+                    m_levels.pop_back();
+                }
+                if (!m_levels.empty() && m_levels.back().query == query) {
+                    return m_levels.back().matches;
+                }
+
+                Level level{ std::wstring(query), {} };
+                if (m_levels.empty()) {
+                    level.matches = m_index->FindFolded(query);
+                }
+                else {
+                    const auto& previous = m_levels.back().matches;
+                    std::copy_if(previous.begin(), previous.end(), std::back_inserter(level.matches), [this, query](id_t id) {
+                        return search::contains(m_index->Items().Folded(id), query);
+                        });
+                }
+
+                if (m_levels.size() == m_maxLevels) {
+                    // the bottom level is the shortest query, and the most expensive one to keep around
+                    m_levels.erase(m_levels.begin());
+                }
+                m_levels.push_back(std::move(level));
+                return m_levels.back().matches;
+            }
+
+            /**
+             * @brief Drops every cached query.
+            */
+            void Clear() noexcept { m_levels.clear(); }
+
+            /**
+             * @brief Switches to another index (e.g. a newer snapshot of a StreamingCatalog), dropping every cached query if it differs from the current one.
+            */
+            void Rebind(std::shared_ptr<const SubstringIndex> index) {
+                if (index != m_index) {
+                    m_index = std::move(index);
+                    m_levels.clear();
+                }
+            }
+
+        private:
+            struct Level {
+                std::wstring query;
+                std::vector<id_t> matches;
+            };
+            std::shared_ptr<const SubstringIndex> m_index;
+            size_t m_maxLevels{};
+            std::vector<Level> m_levels;
+        };
+
+        /**
+         * @brief An edit that turns one list of matches into another; see cppxaml::search::Diff.
+        */
+        struct Edit {
+            enum class Kind : uint8_t {
+                Remove,
+                Insert,
+            };
+            /**
+             * @brief Whether the item at Edit::index gets removed, or an item gets inserted there.
+            */
+            Kind kind;
+            /**
+             * @brief The position of the edit, in the list as it is when the edit gets applied.
+            */
+            uint32_t index;
+            /**
+             * @brief The id of the removed or inserted item.
+            */
+            id_t id;
+        };
+
+        /**
+         * @brief Computes a short sequence of edits that turns one list of ids into another, keeping as many items in place as possible.
+         * @details Each id may appear at most once in each list. The items that stay are the longest subsequence common to both lists:
+         * when both lists are in ascending order (as unranked matches are), that is every common id, found with a linear merge;
+         * otherwise it is found as the longest increasing subsequence of the common ids' new positions, in O(n log n).\n
+         * Removals come first, from the back, followed by insertions, from the front, so that each edit's index is valid when it is applied in order.
+         * @param from The current list.
+         * @param to The new list.
+         * @return The edits.
+        */
+        inline std::vector<Edit> Diff(const std::vector<id_t>& from, const std::vector<id_t>& to) {
+            std::vector<bool> keptOld(from.size());
+            std::vector<bool> keptNew(to.size());
+            auto ascending = [](const std::vector<id_t>& ids) { return std::adjacent_find(ids.begin(), ids.end(), std::greater_equal<id_t>()) == ids.end(); };
+            if (ascending(from) && ascending(to)) {
+                for (size_t i = 0, j = 0; i < from.size() && j < to.size();) {
+                    if (from[i] < to[j]) {
+                        i++;
+                    }
+                    else if (to[j] < from[i]) {
+                        j++;
+                    }
+                    else {
+                        keptOld[i++] = true;
+                        keptNew[j++] = true;
+                    }
+                }
+            }
+            else {
+                std::unordered_map<id_t, uint32_t> positions;
+                positions.reserve(to.size());
+                for (uint32_t j = 0; j < to.size(); j++) {
+                    positions.emplace(to[j], j);
+                }
+                // the common ids, in their old order, with their new position
+                std::vector<std::pair<uint32_t, uint32_t>> common;
+                for (uint32_t i = 0; i < from.size(); i++) {
+                    auto found = positions.find(from[i]);
+                    if (found != positions.end()) {
+                        common.emplace_back(i, found->second);
+                    }
+                }
+                // patience sorting: tails[k] is the entry of common that ends the best increasing run of length k + 1 found so far
+                std::vector<uint32_t> tails;
+                std::vector<uint32_t> previous(common.size());
+                for (uint32_t c = 0; c < common.size(); c++) {
+                    auto at = std::partition_point(tails.begin(), tails.end(), [&](uint32_t t) { return common[t].second < common[c].second; });
+                    previous[c] = at == tails.begin() ? UINT32_MAX : *(at - 1);
+                    if (at == tails.end()) {
+                        tails.push_back(c);
+                    }
+                    else {
+                        *at = c;
+                    }
+                }
+                for (auto c = tails.empty() ? UINT32_MAX : tails.back(); c != UINT32_MAX; c = previous[c]) {
+                    keptOld[common[c].first] = true;
+                    keptNew[common[c].second] = true;
+                }
+            }
+
+            std::vector<Edit> edits;
+            for (auto i = from.size(); i-- > 0;) {
+                if (!keptOld[i]) {
+                    edits.push_back({ Edit::Kind::Remove, static_cast<uint32_t>(i), from[i] });
+                }
+            }
+            for (uint32_t j = 0; j < to.size(); j++) {
+                if (!keptNew[j]) {
+                    edits.push_back({ Edit::Kind::Insert, j, to[j] });
+                }
+            }
+            return edits;
+        }
+
+        /**
+         * @brief A shared, immutable collection of suggestions, together with its search index.
+         * @details Copying a SuggestionCatalog only copies a reference, so one catalog can back any number of `AutoSuggestBox` controls
+         * (see cppxaml::AutoSuggestBox(const cppxaml::search::SuggestionCatalog&)) without each of them holding its own copy of the items or re-indexing them.
+         * Iterating a SuggestionCatalog yields its items as `std::wstring_view`.\n
+         * Example:\n
+         * @code
+         * auto fonts = cppxaml::search::SuggestionCatalog(GetFontFamilies());
+         * auto from = cppxaml::AutoSuggestBox(fonts).EnableDefaultSearch();
+         * auto to = cppxaml::AutoSuggestBox(fonts).EnableDefaultSearch();
+         * @endcode
+        */
+        class SuggestionCatalog {
+        public:
+            /**
+             * @brief Iterates the items of a SuggestionCatalog.
+            */
+            class const_iterator {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = std::wstring_view;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = std::wstring_view;
+
+                const_iterator() = default;
+                const_iterator(const search::Catalog* catalog, id_t id) : m_catalog(catalog), m_id(id) {}
+                std::wstring_view operator*() const noexcept { return m_catalog->Item(m_id); }
+                const_iterator& operator++() noexcept {
+                    m_id++;
+                    return *this;
+                }
+                const_iterator operator++(int) noexcept {
+                    auto copy = *this;
+                    m_id++;
+                    return copy;
+                }
+                bool operator==(const const_iterator& other) const noexcept { return m_id == other.m_id; }
+                bool operator!=(const const_iterator& other) const noexcept { return m_id != other.m_id; }
+
+            private:
+                const search::Catalog* m_catalog{};
+                id_t m_id{};
+            };
+            using value_type = std::wstring_view;
+            using iterator = const_iterator;
+
+            SuggestionCatalog() : m_index(std::make_shared<const SubstringIndex>()) {}
+
+            /**
+             * @brief Wraps an existing index.
+            */
+            explicit SuggestionCatalog(std::shared_ptr<const SubstringIndex> index) : m_index(std::move(index)) {}
+
+            /**
+             * @brief Copies the items into a catalog and indexes them. This is the only time the items get copied.
+             * @tparam TItems A collection of strings, see Catalog::Catalog.
+             * @param items The items.
+             * @param caseInsensitive Whether the index should be case-insensitive. Controls whose search uses the other mode build their own index.
+            */
+            template<typename TItems, typename = std::enable_if_t<!std::is_same_v<std::decay_t<TItems>, SuggestionCatalog>>>
+            explicit SuggestionCatalog(const TItems& items, bool caseInsensitive = true) : m_index(std::make_shared<const SubstringIndex>(items, caseInsensitive)) {}
+
+            /**
+             * @brief The prebuilt index.
+            */
+            const std::shared_ptr<const SubstringIndex>& Index() const noexcept { return m_index; }
+
+            /**
+             * @brief The items.
+            */
+            const search::Catalog& Items() const noexcept { return m_index->Items(); }
+
+            /**
+             * @brief Whether the prebuilt index is case-insensitive.
+            */
+            bool CaseInsensitive() const noexcept { return m_index->CaseInsensitive(); }
+
+            size_t size() const noexcept { return m_index->size(); }
+            bool empty() const noexcept { return size() == 0; }
+            const_iterator begin() const noexcept { return { &Items(), 0 }; }
+            const_iterator end() const noexcept { return { &Items(), static_cast<id_t>(size()) }; }
+            const_iterator cbegin() const noexcept { return begin(); }
+            const_iterator cend() const noexcept { return end(); }
+
+        private:
+            std::shared_ptr<const SubstringIndex> m_index;
+        };
+
+        /**
+         * @brief A collection of suggestions that gets produced, and indexed, a chunk at a time.
+         * @details Items are pulled from a chunk source (a generator) by calling StreamingCatalog::IndexFor repeatedly, e.g. from idle time on the UI thread
+         * (cppxaml::AutoSuggestBox(const cppxaml::search::StreamingCatalog&) does this). Each chunk is appended to the index as a new segment (see SubstringIndex::Append),
+         * and StreamingCatalog::Snapshot returns the index of everything ingested so far, so that searches can start before the whole catalog is available.
+         * Item ids are stable across snapshots.\n
+         * Copying a StreamingCatalog only copies a reference. A StreamingCatalog isn't thread-safe, and should only be used on the thread that ingests it;
+         * the snapshots it returns are immutable, and can be searched on any thread.\n
+         * Example:\n
+         * @code
+         * auto names = std::make_shared<std::vector<std::wstring>>(LoadNames());
+         * auto catalog = cppxaml::search::StreamingCatalog(cppxaml::search::Chunks(names, 4096));
+         * while (catalog.IndexFor(std::chrono::milliseconds(8))) {
+         *     // do other work
+         * }
+         * @endcode
+        */
+        class StreamingCatalog {
+        public:
+            using Chunk = std::vector<std::wstring>;
+            /**
+             * @brief Produces the next chunk of items; an empty chunk signals that there are no more items.
+            */
+            using ChunkSource = std::function<Chunk()>;
+
+            /**
+             * @brief Creates an empty reference, which converts to `false`.
+            */
+            StreamingCatalog() = default;
+
+            /**
+             * @brief Creates a catalog that will pull its items from a chunk source. No items get pulled until StreamingCatalog::IndexNextChunk or StreamingCatalog::IndexFor is called.
+             * @param source The chunk source.
+             * @param caseInsensitive Whether the index should be case-insensitive. Searches over the catalog always use this mode.
+            */
+            explicit StreamingCatalog(ChunkSource source, bool caseInsensitive = true) : m_state(std::make_shared<State>()) {
+                m_state->source = std::move(source);
+                m_state->snapshot = std::make_shared<const SubstringIndex>(std::vector<std::wstring_view>{}, caseInsensitive);
+            }
+
+            explicit operator bool() const noexcept { return m_state != nullptr; }
+
+            /**
+             * @brief The index of the items ingested so far.
+            */
+            std::shared_ptr<const SubstringIndex> Snapshot() const { return m_state->snapshot; }
+
+            /**
+             * @brief Whether the chunk source has been exhausted.
+            */
+            bool Done() const noexcept { return m_state->done; }
+
+            /**
+             * @brief Whether the index is case-insensitive.
+            */
+            bool CaseInsensitive() const noexcept { return m_state->snapshot->CaseInsensitive(); }
+
+            /**
+             * @brief The number of items ingested so far.
+            */
+            size_t size() const noexcept { return m_state->snapshot->size(); }
+
+            /**
+             * @brief Pulls the next chunk from the source, and indexes it.
+             * @return Whether there may be more chunks.
+            */
+            bool IndexNextChunk() const {
+                if (m_state->done) {
+                    return false;
+                }
+                auto chunk = m_state->source();
+                if (chunk.empty()) {
+                    m_state->done = true;
+                    // release whatever the source holds on to
+                    m_state->source = nullptr;
+                    return false;
+                }
+                m_state->snapshot = m_state->snapshot->Append(chunk);
+                return true;
+            }
+
+            /**
+             * @brief Indexes chunks until the time budget is spent (at least one chunk gets indexed), or the source is exhausted.
+             * @param budget The time budget.
+             * @return Whether there may be more chunks.
+            */
+            bool IndexFor(std::chrono::steady_clock::duration budget) const {
+                const auto deadline = std::chrono::steady_clock::now() + budget;
+                while (IndexNextChunk()) {
+                    if (std::chrono::steady_clock::now() >= deadline) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            /**
+             * @brief Marks the catalog as being ingested, so that only one of the controls sharing it schedules the work.
+             * @return Whether the caller should ingest the catalog, i.e. nobody was already doing so and there is work left.
+            */
+            bool TryStartIngestion() const noexcept {
+                if (m_state->ingesting || m_state->done) {
+                    return false;
+                }
+                m_state->ingesting = true;
+                return true;
+            }
+
+        private:
+            struct State {
+                ChunkSource source;
+                std::shared_ptr<const SubstringIndex> snapshot;
+                bool done{ false };
+                bool ingesting{ false };
+            };
+            std::shared_ptr<State> m_state;
+        };
+
+        /**
+         * @brief Makes a chunk source for a StreamingCatalog out of a range of strings, which is only read as chunks get pulled.
+         * @tparam TIterator An input iterator whose elements are convertible to `std::wstring_view`.
+         * @param begin The start of the range.
+         * @param end The end of the range. The range must remain valid until the catalog has ingested it.
+         * @param chunkSize The number of items per chunk.
+        */
+        template<typename TIterator>
+        StreamingCatalog::ChunkSource Chunks(TIterator begin, TIterator end, size_t chunkSize) {
+            return [begin, end, chunkSize]() mutable {
+                StreamingCatalog::Chunk chunk;
+                chunk.reserve(chunkSize);
+                for (; begin != end && chunk.size() < chunkSize; ++begin) {
+                    chunk.emplace_back(std::wstring_view(*begin));
+                }
+                return chunk;
+            };
+        }
+
+        /**
+         * @brief Makes a chunk source for a StreamingCatalog out of a shared collection of strings, which it keeps alive until the catalog has ingested it.
+         * @tparam TItems A collection of strings, e.g. `std::vector<std::wstring>`.
+         * @param items The items.
+         * @param chunkSize The number of items per chunk.
+        */
+        template<typename TItems>
+        StreamingCatalog::ChunkSource Chunks(std::shared_ptr<TItems> items, size_t chunkSize) {
+            auto source = Chunks(std::cbegin(*items), std::cend(*items), chunkSize);
+            return [items = std::move(items), source = std::move(source)]() mutable { return source(); };
+        }
+    }
+
+    namespace utils {
+        /**
+         * @brief Case-insensitive search of a string within another. Unlike comparing the result of utils::tolower, this doesn't allocate, and it is vectorized where possible.
+         * @param haystack The string to search in.
+         * @param needle The string to search for.
+         * @return The position of the first occurrence, or `std::wstring_view::npos`.
+        */
+        inline size_t ifind(std::wstring_view haystack, std::wstring_view needle) noexcept {
+            return cppxaml::search::find(haystack, needle, true);
+        }
+
+        /**
+         * @brief Returns whether a string contains another, ignoring case.
+         * @param haystack
+         * @param needle
+         * @return
+        */
+        inline bool icontains(std::wstring_view haystack, std::wstring_view needle) noexcept {
+            return cppxaml::search::contains(haystack, needle, true);
+        }
+
+        /**
+         * @brief Returns whether two strings are equal, ignoring case.
+         * @param a
+         * @param b
+         * @return
+        */
+        inline bool iequals(std::wstring_view a, std::wstring_view b) noexcept {
+            return cppxaml::search::equals(a, b, true);
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+/** @file
+* @author Alexander Sklar
+* @section LICENSE
+ * Copyright (c) Alexander Sklar
+ *
+ * Licensed under the MIT license
+*/
+
+namespace cppxaml {
+    namespace search {
+
+        /**
+         * @brief The search that runs when the user types in a search box.
+         * @details A handler belongs to the control, not to the wrappers that set it up, so that copying or moving wrappers doesn't add searches. See cppxaml::search::AttachedSearchHandler.
+         * @tparam TControl A handle to the search box.
+        */
+        template<typename TControl>
+        class SearchHandler {
+        public:
+            using Search = std::function<void(const TControl&)>;
+
+            /**
+             * @brief Replaces the search that runs when the user types.
+            */
+            void Set(Search search) { m_search = std::move(search); }
+
+            /**
+             * @brief Runs the search, for a keystroke in `sender`.
+            */
+            void Run(const TControl& sender) {
+                m_invocations++;
+                if (m_search) {
+                    m_search(sender);
+                }
+            }
+
+            /**
+             * @brief The number of searches run, i.e. of keystrokes handled.
+            */
+            uint64_t Invocations() const noexcept { return m_invocations; }
+
+        private:
+            Search m_search;
+            uint64_t m_invocations{ 0 };
+        };
+
+        /**
+         * @brief Gives each search box a single SearchHandler, stored on the control itself.
+         * @details The control's events get subscribed once, the first time search is enabled on it.
+         * Enabling search again (e.g. with other options, or through a copy of the wrapper) only replaces the search that runs,
+         * so each keystroke runs exactly one search, however many times wrappers get copied or moved.\n
+         * `Traits` must provide:
+         * - `control_t`: a handle to the search box;
+         * - `handler_ptr`: a pointer-like handle to a SearchHandler<control_t>, which is null when it is default-constructed;
+         * - `static handler_ptr get(const control_t&)`: returns the control's handler, or null if it has none;
+         * - `static handler_ptr create(const control_t&)`: creates a handler and stores it on the control;
+         * - `static void subscribe(const control_t&, F onUserInput)`: subscribes to the control's events, calling `onUserInput(sender)` when the user types.
+         *
+         * Controls.h provides cppxaml::details::SearchHandler, for XAML's `AutoSuggestBox`.
+        */
+        template<typename Traits>
+        struct AttachedSearchHandler {
+            using control_t = typename Traits::control_t;
+            using handler_ptr = typename Traits::handler_ptr;
+
+            /**
+             * @brief Returns the control's handler, or null if search hasn't been enabled on it.
+            */
+            static handler_ptr Get(const control_t& control) {
+                return Traits::get(control);
+            }
+
+            /**
+             * @brief Returns the control's handler, creating it and subscribing to the control's events if there isn't one yet.
+            */
+            static handler_ptr Attach(const control_t& control) {
+                if (auto handler = Traits::get(control)) {
+                    return handler;
+                }
+                auto handler = Traits::create(control);
+                // the event handler looks the search up on the sender, so that it holds no state of its own
+                Traits::subscribe(control, [](const control_t& sender) {
+                    if (auto handler = Traits::get(sender)) {
+                        handler->Run(sender);
+                    }
+                    });
+                return handler;
+            }
+        };
+    }
+}
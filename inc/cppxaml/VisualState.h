@@ -31,16 +31,16 @@ namespace cppxaml {
         // TODO: make the callback take a template parameter so we don't have to cast from IInspectable
         struct VSMListener : winrt::implements<VSMListener, winrt::Windows::Foundation::IInspectable> {
 
-            VSMListener(cppxaml::xaml::FrameworkElement fe, const std::unordered_map<std::wstring, cppxaml::xaml::VisualStateChangedEventHandler>& map) : m_map(map) {
+            // the handlers get copied into a map that can be looked up by the state's name without allocating a key
+            template<typename TMap>
+            VSMListener(cppxaml::xaml::FrameworkElement fe, const TMap& map) : m_map(std::begin(map), std::end(map)) {
                 if (auto root = FindChildWithVSG(fe)) {
                     for (const cppxaml::xaml::VisualStateGroup& vsg : cppxaml::xaml::VisualStateManager::GetVisualStateGroups(root)) {
                         vsg.CurrentStateChanged([_this = this->get_strong(), fe](winrt::Windows::Foundation::IInspectable sender, cppxaml::xaml::VisualStateChangedEventArgs args) {
 
-                            auto newState = args.NewState();
-                            auto newName = newState.Name();
-                            const auto newNameStr = newName.c_str();
-                            if (_this->m_map.find(newNameStr) != _this->m_map.end()) {
-                                _this->m_map[newNameStr](fe, args);
+                            const auto handler = cppxaml::utils::find_key(_this->m_map, args.NewState().Name());
+                            if (handler != _this->m_map.end()) {
+                                handler->second(fe, args);
                             }
                         });
                     }
@@ -49,12 +49,17 @@ namespace cppxaml {
             }
 
         private:
-            std::unordered_map<std::wstring, cppxaml::xaml::VisualStateChangedEventHandler> m_map{};
+            cppxaml::utils::wstring_map<cppxaml::xaml::VisualStateChangedEventHandler> m_map{};
         };
     }
 
-    template<typename TFrameworkElement>
-    auto VSMListener(TFrameworkElement obj, const std::unordered_map<std::wstring, cppxaml::xaml::VisualStateChangedEventHandler>& map) {
+    /**
+     * @brief Calls a handler whenever the element's visual state changes to the state the handler is mapped to.
+     * @tparam TMap A map from state names to `VisualStateChangedEventHandler`s, e.g. `std::unordered_map<std::wstring, VisualStateChangedEventHandler>`
+     * (the default, which lets the map be passed as a braced list) or a cppxaml::utils::wstring_map.
+    */
+    template<typename TFrameworkElement, typename TMap = std::unordered_map<std::wstring, cppxaml::xaml::VisualStateChangedEventHandler>>
+    auto VSMListener(TFrameworkElement obj, const TMap& map) {
         cppxaml::xaml::FrameworkElement fe(obj);
         if (!fe.Parent()) {
             fe.Loaded([map](winrt::Windows::Foundation::IInspectable sender, auto&) {
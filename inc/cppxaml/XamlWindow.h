@@ -4,6 +4,8 @@
 #include <winrt/Windows.UI.Xaml.Hosting.h>
 #include <Windows.UI.Xaml.Hosting.DesktopWindowXamlSource.h>
 #include <mutex>
+#include <stdexcept>
+#include <cppxaml/utils.h>
 
 /** @file
 * @author Alexander Sklar
@@ -67,7 +69,7 @@ namespace cppxaml {
         std::wstring m_markup;
         winrt::Windows::UI::Xaml::UIElement m_ui{ nullptr };
 
-        static inline std::unordered_map<std::wstring, XamlWindow> s_windows{};
+        static inline cppxaml::utils::wstring_map<XamlWindow> s_windows{};
     public:
         XamlWindow(const XamlWindow&) = delete;
         XamlWindow(XamlWindow&& other) noexcept :
@@ -180,7 +182,11 @@ namespace cppxaml {
          * @return 
         */
         static XamlWindow& Get(std::wstring_view id) {
-            return s_windows.at(std::wstring(id));
+            const auto entry = cppxaml::utils::find_key(s_windows, id);
+            if (entry == s_windows.end()) {
+                throw std::out_of_range("No XamlWindow with this id");
+            }
+            return entry->second;
         }
         static constexpr wchar_t const* const WindowClass() {
             return L"XamlWindow";
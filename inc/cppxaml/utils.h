@@ -1,4 +1,13 @@
 #pragma once
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 /** @file
 * @author Alexander Sklar
@@ -14,12 +23,149 @@
 */
 namespace cppxaml {
 
+// The containers and algorithms below don't need C++/WinRT, so that they can be used (and tested) without it.
+#ifdef WINRT_BASE_H
 #ifdef USE_WINUI3
     namespace xaml = winrt::Microsoft::UI::Xaml;
 #else
     namespace xaml = winrt::Windows::UI::Xaml;
 #endif
+#endif
+
+
+    namespace details {
+        /**
+         * @brief A distinct address for each type `T`, to identify types (or anything named by a tag type) at runtime without RTTI: `&unique_tag<T>`.
+         * @details The variable is deliberately not const. Linkers may merge identical read-only constants (e.g. MSVC's `/OPT:ICF`),
+         * which would give different types the same address; writable data can't be merged.
+        */
+        template<typename T>
+        inline char unique_tag{};
+
+        template<typename T, typename = void>
+        struct has_reserve : std::false_type {};
+        template<typename T>
+        struct has_reserve<T, std::void_t<decltype(std::declval<T&>().reserve(size_t{}))>> : std::true_type {};
+
+        template<typename T, typename = void>
+        struct has_size : std::false_type {};
+        template<typename T>
+        struct has_size<T, std::void_t<decltype(std::declval<const T&>().size())>> : std::true_type {};
+
+        /**
+         * @brief Reserves room for the output of a transform, when both the input's size and the output's `reserve` are available.
+        */
+        template<typename TOut, typename TIn>
+        void reserve_for(TOut& out, const TIn& in) {
+            if constexpr (has_reserve<TOut>::value && has_size<TIn>::value) {
+                out.reserve(in.size());
+            }
+        }
 
+        /**
+         * @brief Folds a character the same way as cppxaml::search::fold, without depending on Search.h.
+        */
+        constexpr wchar_t fold_ascii(wchar_t c) noexcept {
+            return (c >= L'A' && c <= L'Z') ? static_cast<wchar_t>(c + (L'a' - L'A')) : c;
+        }
+
+        /**
+         * @brief Holds a range by reference when it was passed as an lvalue, and by value (moved from) when it was passed as an rvalue.
+        */
+        template<typename TRange>
+        using view_storage_t = std::conditional_t<std::is_lvalue_reference_v<TRange>, TRange, std::remove_cv_t<std::remove_reference_t<TRange>>>;
+
+        /**
+         * @brief A range that maps the elements of another range on the fly, as they are iterated. See cppxaml::utils::transform_view.
+        */
+        template<typename TRange, typename UnaryOp>
+        class transform_view_t {
+            view_storage_t<TRange> m_range;
+            UnaryOp m_op;
+            using base_iterator = decltype(std::cbegin(std::declval<const std::remove_reference_t<TRange>&>()));
+
+        public:
+            class iterator {
+                base_iterator m_it;
+                const UnaryOp* m_op{};
+            public:
+                // the mapped values are produced on dereference, so this can only be an input iterator
+                using iterator_category = std::input_iterator_tag;
+                using reference = std::invoke_result_t<const UnaryOp&, decltype(*std::declval<base_iterator>())>;
+                using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+                using difference_type = typename std::iterator_traits<base_iterator>::difference_type;
+                using pointer = void;
+
+                iterator() = default;
+                iterator(base_iterator it, const UnaryOp* op) : m_it(it), m_op(op) {}
+                reference operator*() const { return (*m_op)(*m_it); }
+                iterator& operator++() { ++m_it; return *this; }
+                iterator operator++(int) { auto old = *this; ++m_it; return old; }
+                bool operator==(const iterator& other) const { return m_it == other.m_it; }
+                bool operator!=(const iterator& other) const { return m_it != other.m_it; }
+            };
+            using const_iterator = iterator;
+            using value_type = typename iterator::value_type;
+
+            transform_view_t(TRange&& range, UnaryOp op) : m_range(std::forward<TRange>(range)), m_op(std::move(op)) {}
+            iterator begin() const { return iterator(std::cbegin(m_range), &m_op); }
+            iterator end() const { return iterator(std::cend(m_range), &m_op); }
+            iterator cbegin() const { return begin(); }
+            iterator cend() const { return end(); }
+            template<typename R = TRange, typename = std::enable_if_t<has_size<std::remove_reference_t<R>>::value>>
+            size_t size() const { return static_cast<size_t>(m_range.size()); }
+        };
+
+        /**
+         * @brief An element of a range along with its index. See cppxaml::utils::enumerate.
+         * @details Supports structured bindings: `auto [index, value] = e;`.
+        */
+        template<typename TReference>
+        struct enumerated {
+            size_t index;
+            TReference value;
+        };
+
+        /**
+         * @brief A range that pairs the elements of another range with their index. See cppxaml::utils::enumerate.
+        */
+        template<typename TRange>
+        class enumerate_view_t {
+            view_storage_t<TRange> m_range;
+            using base_iterator = decltype(std::cbegin(std::declval<const std::remove_reference_t<TRange>&>()));
+
+        public:
+            class iterator {
+                base_iterator m_it;
+                size_t m_index{};
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using reference = enumerated<decltype(*std::declval<base_iterator>())>;
+                using value_type = reference;
+                using difference_type = typename std::iterator_traits<base_iterator>::difference_type;
+                using pointer = void;
+
+                iterator() = default;
+                iterator(base_iterator it, size_t index) : m_it(it), m_index(index) {}
+                reference operator*() const { return reference{ m_index, *m_it }; }
+                iterator& operator++() { ++m_it; ++m_index; return *this; }
+                iterator operator++(int) { auto old = *this; ++*this; return old; }
+                // only the positions are compared, since the end iterator doesn't know its index
+                bool operator==(const iterator& other) const { return m_it == other.m_it; }
+                bool operator!=(const iterator& other) const { return m_it != other.m_it; }
+            };
+            using const_iterator = iterator;
+            using value_type = typename iterator::value_type;
+
+            explicit enumerate_view_t(TRange&& range) : m_range(std::forward<TRange>(range)) {}
+            iterator begin() const { return iterator(std::cbegin(m_range), 0); }
+            iterator end() const { return iterator(std::cend(m_range), 0); }
+            iterator cbegin() const { return begin(); }
+            iterator cend() const { return end(); }
+            template<typename R = TRange, typename = std::enable_if_t<has_size<std::remove_reference_t<R>>::value>>
+            size_t size() const { return static_cast<size_t>(m_range.size()); }
+        };
+    }
 
     /**
      * @namespace cppxaml::utils
@@ -37,6 +183,68 @@ namespace cppxaml {
             return copy;
         }
 
+        /**
+         * @brief Transparent hash for wide-string keys, optionally ignoring (ASCII) case, as per cppxaml::search::fold.
+         * @details Being transparent, it lets maps keyed on `std::wstring` be looked up with a `std::wstring_view`, `winrt::hstring` or `const wchar_t*` without allocating a key.
+         * Use it along with cppxaml::utils::wstring_equal, with the same `CaseInsensitive` setting; see cppxaml::utils::wstring_map.
+         * @tparam CaseInsensitive Whether keys that only differ in case hash the same.
+        */
+        template<bool CaseInsensitive = false>
+        struct wstring_hash {
+            using is_transparent = void;
+
+            size_t operator()(std::wstring_view s) const noexcept {
+                // FNV-1a over the (folded) characters
+                uint64_t h = 14695981039346656037ull;
+                for (auto c : s) {
+                    h ^= static_cast<uint64_t>(CaseInsensitive ? details::fold_ascii(c) : c);
+                    h *= 1099511628211ull;
+                }
+                return static_cast<size_t>(h);
+            }
+        };
+
+        /**
+         * @brief Transparent equality for wide-string keys, optionally ignoring case. See cppxaml::utils::wstring_hash.
+        */
+        template<bool CaseInsensitive = false>
+        struct wstring_equal {
+            using is_transparent = void;
+
+            bool operator()(std::wstring_view a, std::wstring_view b) const noexcept {
+                if constexpr (CaseInsensitive) {
+                    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](wchar_t x, wchar_t y) { return details::fold_ascii(x) == details::fold_ascii(y); });
+                }
+                else {
+                    return a == b;
+                }
+            }
+        };
+
+        /**
+         * @brief An `unordered_map` keyed on `std::wstring` that can be looked up with any wide-string type without allocating.
+         * @details Look entries up with cppxaml::utils::find_key, which falls back to building a `std::wstring` key when the standard library lacks heterogeneous lookup.
+         * @tparam CaseInsensitive Whether keys that only differ in case are the same key.
+        */
+        template<typename TValue, bool CaseInsensitive = false>
+        using wstring_map = std::unordered_map<std::wstring, TValue, wstring_hash<CaseInsensitive>, wstring_equal<CaseInsensitive>>;
+
+        /**
+         * @brief Finds an entry of a cppxaml::utils::wstring_map.
+         * @details Define `CPPXAML_NO_GENERIC_LOOKUP` to use the fallback even when heterogeneous lookup is available (e.g. to test it).
+         * @param map The map.
+         * @param key The key, e.g. a `std::wstring_view` or a `winrt::hstring`.
+         * @return An iterator to the entry, or `map.end()`.
+        */
+        template<typename TMap, typename TKey>
+        auto find_key(TMap& map, const TKey& key) {
+#if defined(__cpp_lib_generic_unordered_lookup) && !defined(CPPXAML_NO_GENERIC_LOOKUP)
+            return map.find(std::wstring_view(key));
+#else
+            return map.find(typename TMap::key_type(std::wstring_view(key)));
+#endif
+        }
+
         /**
          * @brief Maps each element in a container via a unary operation on each element
          * @tparam TOutContainer The output container type. Defaults to std::vector.
@@ -54,6 +262,7 @@ namespace cppxaml {
         auto transform(TInContainer const& iterable, UnaryOp&& unary_op) {
             using result_t = std::invoke_result_t<UnaryOp, typename TInContainer::value_type>;
             TOutContainer<result_t> out{};
+            details::reserve_for(out, iterable);
             auto o = std::inserter(out, out.end());
             for (auto i = iterable.cbegin(); i != iterable.cend(); i++) {
                 o = unary_op(*i);
@@ -100,6 +309,7 @@ namespace cppxaml {
         auto transform_with_index(TInContainer const& iterable, UnaryOp&& unary_op) {
             using result_t = std::invoke_result_t<UnaryOp, typename TInContainer::value_type, typename TInContainer::const_iterator::difference_type>;
             TOutContainer<result_t> out{};
+            details::reserve_for(out, iterable);
             auto o = std::inserter(out, out.end());
             for (auto i = iterable.cbegin(); i != iterable.cend(); i++) {
                 o = unary_op(*i, i - iterable.cbegin());
@@ -107,8 +317,52 @@ namespace cppxaml {
             return out;
         }
 
+        /**
+         * @brief Lazily maps each element of a range via a unary operation.
+         * @details Unlike cppxaml::utils::transform, nothing gets materialized: `unary_op` runs as the returned view is iterated, one element at a time.
+         * Builders like cppxaml::Grid, cppxaml::MakePanel and cppxaml::MakeItemsControl consume views directly, so large panels can be built without an intermediate container.\n
+         * The view references `iterable` if it is an lvalue (which must then outlive the view), and takes ownership of it otherwise.
+         * Each iteration of the view calls `unary_op` again.\n
+         * Example:\n
+         * @code
+         * auto strs = std::vector<std::wstring>{ L"first", L"second", L"third" };
+         * auto sp = cppxaml::MakePanel<StackPanel>(cppxaml::utils::transform_view(strs, [](const std::wstring& t) {
+         *     return cppxaml::TextBlock(t);
+         * }));
+         * @endcode
+         * @param iterable The range.
+         * @param unary_op The lambda for the unary operation; takes the element type of the range.
+         * @return An input range of the mapped elements.
+        */
+        template<typename TRange, typename UnaryOp>
+        auto transform_view(TRange&& iterable, UnaryOp&& unary_op) {
+            return details::transform_view_t<TRange, std::decay_t<UnaryOp>>(std::forward<TRange>(iterable), std::forward<UnaryOp>(unary_op));
+        }
+
+        /**
+         * @brief Lazily pairs each element of a range with its index.
+         * @details The elements of the returned view have an `index` and a `value` (a reference into `iterable`), and support structured bindings.
+         * Combined with cppxaml::utils::transform_view, this is the lazy counterpart of cppxaml::utils::transform_with_index.\n
+         * Example:\n
+         * @code
+         * auto strs = std::vector<std::wstring>{ L"first", L"second", L"third", L"fourth" };
+         * auto grid = cppxaml::Grid({"40, *"}, {"Auto, Auto"},
+         *      cppxaml::utils::transform_view(cppxaml::utils::enumerate(strs), [](const auto& e) {
+         *          auto& [index, t] = e;
+         *          return cppxaml::details::UIElementInGrid{ (int)index / 2, (int)index % 2, cppxaml::Button(winrt::hstring(t)) };
+         *      }));
+         * @endcode
+         * @param iterable The range. As with cppxaml::utils::transform_view, it is referenced if it is an lvalue, and owned by the view otherwise.
+         * @return An input range of `{index, value}` elements.
+        */
+        template<typename TRange>
+        auto enumerate(TRange&& iterable) {
+            return details::enumerate_view_t<TRange>(std::forward<TRange>(iterable));
+        }
+
     }
 
+#ifdef WINRT_BASE_H
     /**
      * @brief Finds a XAML element by name.
      * @tparam T Expected type of the element - defaults to DependencyObject.
@@ -123,10 +377,11 @@ namespace cppxaml {
         }
         for (int i = 0; i < cppxaml::xaml::Media::VisualTreeHelper::GetChildrenCount(d); i++) {
             auto r = FindChildByName<T>(cppxaml::xaml::Media::VisualTreeHelper::GetChild(d, i), name);
-            if (r) return r.as<T>();
+            if (r) return r.template as<T>();
         }
         return nullptr;
     }
+#endif
 
 
 }
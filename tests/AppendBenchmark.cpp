@@ -0,0 +1,61 @@
+// Streams a 1M-item catalog into a StreamingCatalog in 4096-item chunks, and compares how long the first and the last chunks take to append:
+// appending writes the new items in place, so the cost of a chunk shouldn't grow with the number of items already indexed.
+#include "test.h"
+#include <cppxaml/Search.h>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    std::shared_ptr<std::vector<std::wstring>> MakeCatalog(size_t count) {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> length(8, 40);
+        std::uniform_int_distribution<int> letter(0, 51);
+        auto items = std::make_shared<std::vector<std::wstring>>(count);
+        for (auto& item : *items) {
+            item.resize(static_cast<size_t>(length(rng)));
+            for (auto& c : item) {
+                const auto l = letter(rng);
+                c = static_cast<wchar_t>(l < 26 ? L'a' + l : L'A' + (l - 26));
+            }
+        }
+        return items;
+    }
+}
+
+int main() {
+    constexpr size_t count = 1000000;
+    constexpr size_t chunkSize = 4096;
+    const auto items = MakeCatalog(count);
+    cppxaml::search::StreamingCatalog catalog(cppxaml::search::Chunks(items, chunkSize));
+
+    std::vector<double> chunkMs;
+    for (bool more = true; more;) {
+        const auto start = std::chrono::steady_clock::now();
+        more = catalog.IndexNextChunk();
+        chunkMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    CHECK(catalog.size() == count);
+    CHECK(catalog.Snapshot()->Items().Item(count - 1) == items->back());
+    CHECK(catalog.Snapshot()->Find(items->back()).size() >= 1);
+
+    // the last entry timed the empty chunk that ends the stream
+    chunkMs.pop_back();
+    const size_t window = chunkMs.size() / 10;
+    double first = 0;
+    double last = 0;
+    for (size_t i = 0; i < window; i++) {
+        first += chunkMs[i];
+        last += chunkMs[chunkMs.size() - 1 - i];
+    }
+    double total = 0;
+    for (auto ms : chunkMs) {
+        total += ms;
+    }
+    std::printf("%zu chunks of %zu items: %.1f ms total; first %zu chunks %.3f ms/chunk, last %zu chunks %.3f ms/chunk (%.2fx)\n",
+        chunkMs.size(), chunkSize, total, window, first / window, window, last / window, last / first);
+    return TEST_RESULT();
+}
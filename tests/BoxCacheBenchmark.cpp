@@ -0,0 +1,75 @@
+// Replays the values set while building a 100 x 100 grid (10k cells): each cell gets its row, its column, a margin, an alignment and a font size.
+// Reports the box cache's hit rate, and compares the time taken with boxing every value.
+// The boxes here are heap allocations; XAML boxes (IPropertyValue objects) cost an activation each, so the cache saves more there.
+#include "test.h"
+#include <cppxaml/BoxCache.h>
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <type_traits>
+
+namespace {
+    struct Thickness {
+        double left;
+        double top;
+        double right;
+        double bottom;
+    };
+
+    enum class Alignment { Stretch, Left, Center, Right };
+
+    struct HeapBoxTraits {
+        using boxed_type = std::shared_ptr<const void>;
+
+        template<typename TValue>
+        static constexpr bool is_struct = std::is_same_v<TValue, Thickness>;
+
+        template<typename TValue>
+        static boxed_type Box(const TValue& value) {
+            return std::make_shared<const TValue>(value);
+        }
+
+        static void Encode(const Thickness& value, std::array<uint64_t, 4>& bits) noexcept {
+            using cppxaml::details::box_key_bits;
+            bits = { box_key_bits(value.left), box_key_bits(value.top), box_key_bits(value.right), box_key_bits(value.bottom) };
+        }
+    };
+
+    using Cache = cppxaml::details::BasicBoxCache<HeapBoxTraits>;
+
+    template<typename Box>
+    size_t BuildGrid(size_t rows, size_t columns, Box&& box) {
+        size_t count = 0;
+        for (size_t r = 0; r < rows; r++) {
+            for (size_t c = 0; c < columns; c++) {
+                count += box(static_cast<int32_t>(r)) != nullptr;
+                count += box(static_cast<int32_t>(c)) != nullptr;
+                count += box(Thickness{ 4, 2, 4, 2 }) != nullptr;
+                count += box(c % 2 ? Alignment::Left : Alignment::Center) != nullptr;
+                count += box(14.0) != nullptr;
+            }
+        }
+        return count;
+    }
+}
+
+int main() {
+    constexpr size_t rows = 100;
+    constexpr size_t columns = 100;
+
+    Cache cache;
+    size_t setters = BuildGrid(rows, columns, [&](const auto& value) { return cache.Box(value); });
+    const auto& stats = cache.Stats();
+    CHECK(setters == rows * columns * 5);
+    CHECK(stats.hits + stats.misses == setters);
+    // every distinct value gets boxed once: 100 rows (which cover the columns' values), a margin, 2 alignments and a font size
+    CHECK(stats.misses == rows + 4);
+    std::printf("%zu cells, %zu boxed values: %llu hits, %llu misses (%.2f%% hit rate), %zu boxes cached\n",
+        rows * columns, setters, static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(stats.misses),
+        100.0 * static_cast<double>(stats.hits) / static_cast<double>(setters), cache.size());
+
+    const auto cachedMs = cppxaml_tests::MeasureMs([&] { BuildGrid(rows, columns, [&](const auto& value) { return cache.Box(value); }); });
+    const auto uncachedMs = cppxaml_tests::MeasureMs([&] { BuildGrid(rows, columns, [](const auto& value) { return HeapBoxTraits::Box(value); }); });
+    std::printf("boxing every value %.3f ms, through the cache %.3f ms (%.2fx)\n", uncachedMs, cachedMs, uncachedMs / cachedMs);
+    return TEST_RESULT();
+}
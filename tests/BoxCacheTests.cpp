@@ -0,0 +1,144 @@
+#include "test.h"
+#include <cppxaml/BoxCache.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace {
+    struct Margin {
+        double left;
+        double top;
+        double right;
+        double bottom;
+    };
+
+    enum class Alignment { Left, Center, Right };
+
+    // boxes into shared pointers, and counts the boxes made
+    struct TestBoxTraits {
+        using boxed_type = std::shared_ptr<const void>;
+
+        template<typename TValue>
+        static constexpr bool is_struct = std::is_same_v<TValue, Margin>;
+
+        template<typename TValue>
+        static boxed_type Box(const TValue& value) {
+            boxes++;
+            return std::make_shared<const TValue>(value);
+        }
+
+        static void Encode(const Margin& value, std::array<uint64_t, 4>& bits) noexcept {
+            using cppxaml::details::box_key_bits;
+            bits = { box_key_bits(value.left), box_key_bits(value.top), box_key_bits(value.right), box_key_bits(value.bottom) };
+        }
+
+        static inline int boxes = 0;
+    };
+
+    using Cache = cppxaml::details::BasicBoxCache<TestBoxTraits>;
+
+    static_assert(Cache::cacheable<int> && Cache::cacheable<bool> && Cache::cacheable<double> && Cache::cacheable<Alignment> && Cache::cacheable<Margin>);
+    static_assert(!Cache::cacheable<std::shared_ptr<int>>);
+
+    template<typename TValue>
+    TValue Unbox(const Cache::boxed_type& boxed) {
+        return *static_cast<const TValue*>(boxed.get());
+    }
+
+    void TestReuse() {
+        Cache cache;
+        TestBoxTraits::boxes = 0;
+        const auto a = cache.Box(42);
+        const auto b = cache.Box(42);
+        CHECK(a == b);
+        CHECK(Unbox<int>(a) == 42);
+        CHECK(cache.Box(43) != a);
+        CHECK(TestBoxTraits::boxes == 2);
+        CHECK(cache.Stats().hits == 1 && cache.Stats().misses == 2);
+
+        const auto m = cache.Box(Margin{ 4, 4, 4, 4 });
+        CHECK(cache.Box(Margin{ 4, 4, 4, 4 }) == m);
+        CHECK(cache.Box(Margin{ 4, 4, 4, 8 }) != m);
+        CHECK(Unbox<Margin>(m).bottom == 4);
+    }
+
+    void TestTypesDontCollide() {
+        // the same bits in different types must get different boxes
+        Cache cache;
+        const auto i = cache.Box(1);
+        const auto u = cache.Box(1u);
+        const auto l = cache.Box(int64_t{ 1 });
+        const auto b = cache.Box(true);
+        const auto e = cache.Box(static_cast<Alignment>(1));
+        const Cache::boxed_type boxes[] = { i, u, l, b, e };
+        for (size_t x = 0; x < std::size(boxes); x++) {
+            for (size_t y = x + 1; y < std::size(boxes); y++) {
+                CHECK(boxes[x] != boxes[y]);
+            }
+        }
+        CHECK(cache.size() == 5);
+        CHECK(Unbox<Alignment>(e) == Alignment::Center);
+        CHECK(cache.Box(1.0f) != cache.Box(1.0));
+
+        // and so must values that compare equal but have different bits
+        CHECK(cache.Box(0.0) != cache.Box(-0.0));
+    }
+
+    void TestEviction() {
+        Cache cache(2);
+        const auto one = cache.Box(1);
+        cache.Box(2);
+        // 1 is now the most recently used, so 2 gets evicted
+        CHECK(cache.Box(1) == one);
+        cache.Box(3);
+        CHECK(cache.size() == 2);
+        CHECK(cache.Stats().evicted == 1);
+        CHECK(cache.Box(1) == one);
+        const auto misses = cache.Stats().misses;
+        cache.Box(2);
+        CHECK(cache.Stats().misses == misses + 1);
+
+        cache.Capacity(1);
+        CHECK(cache.size() == 1);
+        cache.Clear();
+        CHECK(cache.size() == 0);
+
+        cache.Capacity(0);
+        CHECK(cache.Box(5) != cache.Box(5));
+        CHECK(cache.size() == 0);
+    }
+
+    using Scope = cppxaml::details::BasicBoxCacheScope<TestBoxTraits>;
+
+    void TestScope() {
+        // caching is opt-in
+        CHECK(Scope::Current() == nullptr);
+        Cache::boxed_type kept;
+        {
+            Scope outer;
+            CHECK(Scope::Current() == &outer.Cache());
+            kept = Scope::Current()->Box(7);
+            CHECK(Scope::Current()->Box(7) == kept);
+            {
+                Scope inner(4);
+                CHECK(Scope::Current() == &inner.Cache());
+                CHECK(Scope::Current()->Capacity() == 4);
+                CHECK(Scope::Current()->Box(7) != kept);
+            }
+            CHECK(Scope::Current() == &outer.Cache());
+            CHECK(kept.use_count() == 2);
+        }
+        // the scope's boxes are released with it
+        CHECK(Scope::Current() == nullptr);
+        CHECK(kept.use_count() == 1);
+    }
+}
+
+int main() {
+    TestReuse();
+    TestTypesDontCollide();
+    TestEviction();
+    TestScope();
+    return TEST_RESULT();
+}
@@ -0,0 +1,222 @@
+// Pass the path of the BuildCatalog tool as the first argument to also test it end to end (tests/CMakeLists.txt does).
+#include "test.h"
+#include <cppxaml/CatalogFile.h>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cppxaml::search;
+namespace search = cppxaml::search;
+
+namespace {
+    std::filesystem::path TempPath(const char* name) {
+        return std::filesystem::temp_directory_path() / (std::string("cppxaml_") + name);
+    }
+
+    std::string Serialize(const SubstringIndex& index) {
+        std::ostringstream out(std::ios::binary);
+        WriteCatalogFile(out, index);
+        return out.str();
+    }
+
+    void WriteBytes(const std::filesystem::path& path, const std::string& bytes) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    bool Rejected(const std::string& bytes) {
+        const auto path = TempPath("rejected.cxsc");
+        WriteBytes(path, bytes);
+        try {
+            LoadCatalogFile(path);
+            return false;
+        }
+        catch (const std::runtime_error&) {
+            return true;
+        }
+    }
+
+    CatalogFileHeader Header(const std::string& bytes) {
+        CatalogFileHeader header{};
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        return header;
+    }
+
+    std::string WithHeader(std::string bytes, const std::function<void(CatalogFileHeader&)>& edit) {
+        auto header = Header(bytes);
+        edit(header);
+        std::memcpy(bytes.data(), &header, sizeof(header));
+        return bytes;
+    }
+
+    std::string WithUint32(std::string bytes, size_t at, uint32_t value) {
+        std::memcpy(bytes.data() + at, &value, sizeof(value));
+        return bytes;
+    }
+
+    // the loaded catalog has the same items, and finds the same matches, as the index it was written from
+    void CheckSame(const SubstringIndex& written, const SuggestionCatalog& loaded, const std::vector<std::wstring>& queries) {
+        const auto& index = *loaded.Index();
+        CHECK(index.size() == written.size());
+        CHECK(index.CaseInsensitive() == written.CaseInsensitive());
+        for (id_t id = 0; id < written.size() && id < index.size(); id++) {
+            CHECK(index.Items().Item(id) == written.Items().Item(id));
+        }
+        for (const auto& query : queries) {
+            CHECK(index.Find(query) == written.Find(query));
+        }
+    }
+
+    const std::vector<std::wstring> fonts{ L"Arial", L"Segoe UI", L"Calibri", L"Times New Roman", L"Courier New", L"Caf\u00e9 Sans", L"CALIBRI Light" };
+
+    void TestRoundTrip() {
+        const auto path = TempPath("fonts.cxsc");
+        for (bool caseInsensitive : { true, false }) {
+            const SubstringIndex index(fonts, caseInsensitive);
+            WriteCatalogFile(path, index);
+            const auto loaded = LoadCatalogFile(path);
+            CheckSame(index, loaded, { L"a", L"ri", L"CALI", L"new", L"caf\u00e9", L"xyz", L"" });
+            CHECK(loaded.Index()->Find(L"calibri").size() == (caseInsensitive ? 2 : 0));
+        }
+
+        // an appended index has several suffix arrays, which get merged into one
+        auto appended = SubstringIndex(fonts, true).Append(std::vector<std::wstring>{ L"Consolas", L"Cascadia Code" });
+        WriteCatalogFile(path, *appended);
+        CheckSame(*appended, LoadCatalogFile(path), { L"c", L"co", L"cas", L"sol" });
+    }
+
+    void TestEmptyCatalog() {
+        const auto path = TempPath("empty.cxsc");
+        const SubstringIndex index(std::vector<std::wstring>{}, true);
+        WriteCatalogFile(path, index);
+        const auto loaded = LoadCatalogFile(path);
+        CHECK(loaded.Index()->size() == 0);
+        CHECK(loaded.Index()->Find(L"a").empty());
+        CHECK(loaded.Index()->Find(L"").empty());
+    }
+
+    void TestSurrogates() {
+        // U+1F600 takes a surrogate pair in the file; where wchar_t is UTF-32, loading combines them again and rebuilds the index
+        const std::vector<std::wstring> items{ L"smile \U0001F600", L"plain", L"\U0001F600\U0001F600 twice" };
+        const SubstringIndex index(items, true);
+        const auto path = TempPath("surrogates.cxsc");
+        WriteCatalogFile(path, index);
+        const auto loaded = LoadCatalogFile(path);
+        CheckSame(index, loaded, { L"\U0001F600", L"ice", L"e \U0001F600", L"plain" });
+        CHECK(loaded.Index()->Find(L"\U0001F600") == (std::vector<id_t>{ 0, 2 }));
+    }
+
+    void TestRejected() {
+        const auto bytes = Serialize(SubstringIndex(fonts, true));
+        const auto header = Header(bytes);
+        CHECK(!Rejected(bytes));
+
+        // header validation
+        CHECK(Rejected(""));
+        CHECK(Rejected(bytes.substr(0, sizeof(CatalogFileHeader) - 1)));
+        CHECK(Rejected(WithHeader(bytes, [](auto& h) { h.signature = 0x12345678; })));
+        CHECK(Rejected(WithHeader(bytes, [](auto& h) { h.version = CatalogFileHeader::currentVersion + 1; })));
+        CHECK(Rejected(WithHeader(bytes, [](auto& h) { h.count += 1; })));
+        CHECK(Rejected(WithHeader(bytes, [](auto& h) { h.textLength += 1; })));
+        CHECK(Rejected(WithHeader(bytes, [](auto& h) { h.suffixCount -= 1; })));
+        CHECK(Rejected(WithHeader(bytes, [](auto& h) { h.count = 0xFFFFFFFF; })));
+
+        // truncated files
+        for (size_t length : { sizeof(CatalogFileHeader), sizeof(CatalogFileHeader) + 8, bytes.size() / 2, bytes.size() - 4, bytes.size() - 1 }) {
+            CHECK(Rejected(bytes.substr(0, length)));
+        }
+
+        // corrupt sections
+        const size_t offsetsAt = sizeof(CatalogFileHeader);
+        CHECK(Rejected(WithUint32(bytes, offsetsAt, 2)));                                  // the first item doesn't start at 0
+        CHECK(Rejected(WithUint32(bytes, offsetsAt + 4, 0)));                              // an empty slot for the first item
+        CHECK(Rejected(WithUint32(bytes, offsetsAt + header.count * 4, header.textLength - 1))); // the pool's length disagrees
+        const size_t originalAt = offsetsAt + ((header.count + 1) * 4 + 3) / 4 * 4;
+        std::string unterminated = bytes;
+        unterminated[originalAt + 5 * 2] = 'x';                                            // "Arial" loses its terminator
+        CHECK(Rejected(unterminated));
+        const size_t suffixesAt = bytes.size() - header.suffixCount * 4;
+        CHECK(Rejected(WithUint32(bytes, suffixesAt, header.textLength)));                 // a suffix past the text
+
+        // missing file
+        bool threw = false;
+        try {
+            LoadCatalogFile(TempPath("does_not_exist.cxsc"));
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    void TestUtf8() {
+        using search::details::from_utf8;
+        CHECK(from_utf8("Arial") == L"Arial");
+        CHECK(from_utf8("Caf\xC3\xA9") == L"Caf\u00e9");
+        CHECK(from_utf8("\xE2\x82\xAC") == L"\u20ac");
+        const auto emoji = from_utf8("\xF0\x9F\x98\x80");
+        CHECK(emoji == (sizeof(wchar_t) == 2 ? std::wstring{ static_cast<wchar_t>(0xD83D), static_cast<wchar_t>(0xDE00) } : std::wstring{ static_cast<wchar_t>(0x1F600) }));
+        // the largest code point for each length decodes
+        CHECK(from_utf8("\x7F\xDF\xBF\xEF\xBF\xBF").size() == 3);
+        CHECK(from_utf8("\xF4\x8F\xBF\xBF").size() == (sizeof(wchar_t) == 2 ? 2 : 1));
+
+        // overlong encodings of "/" (U+002F), U+07FF and U+FFFF are rejected, one U+FFFD per byte
+        CHECK(from_utf8("\xC0\xAF") == L"\ufffd\ufffd");
+        CHECK(from_utf8("\xC1\xBF") == L"\ufffd\ufffd");
+        CHECK(from_utf8("\xE0\x80\xAF") == L"\ufffd\ufffd\ufffd");
+        CHECK(from_utf8("\xE0\x9F\xBF") == L"\ufffd\ufffd\ufffd");
+        CHECK(from_utf8("\xF0\x80\x80\xAF") == L"\ufffd\ufffd\ufffd\ufffd");
+        CHECK(from_utf8("\xF0\x8F\xBF\xBF") == L"\ufffd\ufffd\ufffd\ufffd");
+        // so is the overlong null some encoders use
+        CHECK(from_utf8("a\xC0\x80z") == L"a\ufffd\ufffdz");
+
+        // surrogates, code points past U+10FFFF, and broken sequences
+        CHECK(from_utf8("\xED\xA0\x80") == L"\ufffd\ufffd\ufffd");
+        CHECK(from_utf8("\xF4\x90\x80\x80") == L"\ufffd\ufffd\ufffd\ufffd");
+        CHECK(from_utf8("\xC3") == L"\ufffd");
+        CHECK(from_utf8("\xC3z") == L"\ufffdz");
+        CHECK(from_utf8("\x80\xBF") == L"\ufffd\ufffd");
+        CHECK(from_utf8("\xFF") == L"\ufffd");
+        CHECK(from_utf8("") == L"");
+    }
+
+    void TestBuildCatalogTool(const char* tool) {
+        const auto input = TempPath("tool_input.txt");
+        const auto output = TempPath("tool_output.cxsc");
+        // a BOM, CRLF line endings, an empty line, and an overlong sequence
+        WriteBytes(input, "\xEF\xBB\xBF" "Arial\r\nCaf\xC3\xA9 Sans\r\n\r\nbad \xC0\xAF slash\nSegoe UI\n");
+        std::filesystem::remove(output);
+        std::string command;
+        for (const auto& arg : { std::string(tool), input.string(), output.string() }) {
+            command.append(command.empty() ? "\"" : " \"").append(arg).append("\"");
+        }
+        CHECK(std::system(command.c_str()) == 0);
+        const auto loaded = LoadCatalogFile(output);
+        const auto& catalog = loaded.Index()->Items();
+        CHECK(catalog.size() == 4);
+        if (catalog.size() == 4) {
+            CHECK(catalog.Item(0) == L"Arial");
+            CHECK(catalog.Item(1) == L"Caf\u00e9 Sans");
+            CHECK(catalog.Item(2) == L"bad \ufffd\ufffd slash");
+            CHECK(catalog.Item(3) == L"Segoe UI");
+        }
+        CHECK(loaded.Index()->Find(L"CAF\u00e9") == std::vector<id_t>{ 1 });
+    }
+}
+
+int main(int argc, char** argv) {
+    TestRoundTrip();
+    TestEmptyCatalog();
+    TestSurrogates();
+    TestRejected();
+    TestUtf8();
+    if (argc > 1) {
+        TestBuildCatalogTool(argv[1]);
+    }
+    return TEST_RESULT();
+}
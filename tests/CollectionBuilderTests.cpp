@@ -0,0 +1,327 @@
+#include "test.h"
+#include <cppxaml/CollectionBuilder.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    // Every call through the traits is logged, so that the builder's count of crossings can be checked against the calls it actually made.
+    std::vector<std::string>& Calls() {
+        static std::vector<std::string> calls;
+        return calls;
+    }
+
+    struct FakeElement {
+        std::wstring text;
+        int row{ -1 };
+        int column{ -1 };
+    };
+
+    struct FakeDefinition {
+        double length{ -1 };
+    };
+
+    struct FakeItem {
+        std::wstring text;
+    };
+
+    // Stands in for a panel, a grid or an items control.
+    struct FakeControl {
+        struct State {
+            std::vector<std::shared_ptr<FakeElement>> children;
+            std::vector<FakeDefinition> rows;
+            std::vector<FakeDefinition> columns;
+            std::vector<FakeItem> items;
+            const void* replacedFrom{};
+        };
+        std::shared_ptr<State> state = std::make_shared<State>();
+    };
+
+    struct FakeTraits {
+        using element_t = std::shared_ptr<FakeElement>;
+        struct placed_t {
+            int m_row{};
+            int m_column{};
+            element_t m_element;
+        };
+        using item_t = FakeItem;
+
+        static item_t box(int value) {
+            Calls().push_back("box");
+            return FakeItem{ std::to_wstring(value) };
+        }
+
+        template<typename T>
+        struct collection {
+            std::vector<T>* values;
+            const void** replacedFrom;
+        };
+
+        static auto children(const FakeControl& control) {
+            Calls().push_back("children");
+            return collection<element_t>{ &control.state->children, &control.state->replacedFrom };
+        }
+        static auto row_definitions(const FakeControl& control) {
+            Calls().push_back("row_definitions");
+            return collection<FakeDefinition>{ &control.state->rows, &control.state->replacedFrom };
+        }
+        static auto column_definitions(const FakeControl& control) {
+            Calls().push_back("column_definitions");
+            return collection<FakeDefinition>{ &control.state->columns, &control.state->replacedFrom };
+        }
+        static auto items(const FakeControl& control) {
+            Calls().push_back("items");
+            return collection<item_t>{ &control.state->items, &control.state->replacedFrom };
+        }
+
+        template<typename T>
+        static void replace_all(collection<T>& c, const T* first, const T* last) {
+            Calls().push_back("replace_all");
+            c.values->assign(first, last);
+            *c.replacedFrom = first;
+        }
+
+        // the item-at-a-time counterpart of replace_all, for the builders below that measure what batching saves
+        template<typename T>
+        static void append(collection<T>& c, const T& value) {
+            Calls().push_back("append");
+            c.values->push_back(value);
+        }
+
+        static FakeDefinition create_row_definition() {
+            Calls().push_back("create_row_definition");
+            return {};
+        }
+        static FakeDefinition create_column_definition() {
+            Calls().push_back("create_column_definition");
+            return {};
+        }
+        static void set_height(FakeDefinition& rd, double length) {
+            Calls().push_back("set_height");
+            rd.length = length;
+        }
+        static void set_width(FakeDefinition& cd, double length) {
+            Calls().push_back("set_width");
+            cd.length = length;
+        }
+
+        static element_t as_framework_element(const element_t& element) {
+            Calls().push_back("as_framework_element");
+            return element;
+        }
+        static void set_row(const element_t& fe, int row) {
+            Calls().push_back("set_row");
+            fe->row = row;
+        }
+        static void set_column(const element_t& fe, int column) {
+            Calls().push_back("set_column");
+            fe->column = column;
+        }
+    };
+
+    using Builder = cppxaml::details::CollectionBuilder<FakeTraits>;
+    using Placed = FakeTraits::placed_t;
+
+    // What the builders did before batching: one Append per item, each through a fresh collection getter, and two QueryInterface calls per placed child.
+    // Every call is one crossing here too, so that the counts compare.
+    struct AppendEachBuilder {
+        template<typename Call>
+        static decltype(auto) Cross(Call&& call) {
+            cppxaml::details::BuilderStats().crossings++;
+            return call();
+        }
+
+        template<typename TItems>
+        static void AddItems(const FakeControl& control, const TItems& items) {
+            for (auto& i : items) {
+                auto boxed = Cross([&] { return FakeTraits::box(i); });
+                auto collection = Cross([&] { return FakeTraits::items(control); });
+                Cross([&] { FakeTraits::append(collection, boxed); });
+            }
+        }
+
+        template<typename TElements>
+        static void AddChildren(const FakeControl& control, const TElements& elems) {
+            for (auto& e : elems) {
+                auto children = Cross([&] { return FakeTraits::children(control); });
+                Cross([&] { FakeTraits::append(children, e); });
+            }
+        }
+
+        static void AddGridContents(const FakeControl& grid, const std::vector<double>& rows, const std::vector<double>& columns, const std::vector<Placed>& elems) {
+            for (auto r : rows) {
+                auto rd = Cross([] { return FakeTraits::create_row_definition(); });
+                Cross([&] { FakeTraits::set_height(rd, r); });
+                auto definitions = Cross([&] { return FakeTraits::row_definitions(grid); });
+                Cross([&] { FakeTraits::append(definitions, rd); });
+            }
+            for (auto c : columns) {
+                auto cd = Cross([] { return FakeTraits::create_column_definition(); });
+                Cross([&] { FakeTraits::set_width(cd, c); });
+                auto definitions = Cross([&] { return FakeTraits::column_definitions(grid); });
+                Cross([&] { FakeTraits::append(definitions, cd); });
+            }
+            for (auto& e : elems) {
+                auto children = Cross([&] { return FakeTraits::children(grid); });
+                Cross([&] { FakeTraits::append(children, e.m_element); });
+                const auto forRow = Cross([&] { return FakeTraits::as_framework_element(e.m_element); });
+                Cross([&] { FakeTraits::set_row(forRow, e.m_row); });
+                const auto forColumn = Cross([&] { return FakeTraits::as_framework_element(e.m_element); });
+                Cross([&] { FakeTraits::set_column(forColumn, e.m_column); });
+            }
+        }
+    };
+
+    std::vector<std::shared_ptr<FakeElement>> MakeElements(size_t count) {
+        std::vector<std::shared_ptr<FakeElement>> elements;
+        for (size_t i = 0; i < count; i++) {
+            elements.push_back(std::make_shared<FakeElement>(FakeElement{ std::to_wstring(i) }));
+        }
+        return elements;
+    }
+
+    std::vector<Placed> Place(const std::vector<std::shared_ptr<FakeElement>>& elements, int columns) {
+        std::vector<Placed> placed;
+        for (size_t i = 0; i < elements.size(); i++) {
+            placed.push_back(Placed{ static_cast<int>(i) / columns, static_cast<int>(i) % columns, elements[i] });
+        }
+        return placed;
+    }
+
+    // Runs f, and returns the crossings it counted, after checking that each of them is a call the traits saw.
+    template<typename F>
+    uint64_t CountCrossings(F&& f) {
+        Calls().clear();
+        cppxaml::details::BuilderStats() = {};
+        f();
+        CHECK(cppxaml::details::BuilderStats().crossings == Calls().size());
+        return cppxaml::details::BuilderStats().crossings;
+    }
+
+    void TestPanel() {
+        const auto elements = MakeElements(3);
+        FakeControl panel;
+        const auto crossings = CountCrossings([&] { Builder::AddChildren(panel, elements); });
+        CHECK(crossings == 2);
+        CHECK(cppxaml::details::BuilderStats().added == 3);
+        CHECK(panel.state->children == elements);
+        CHECK((Calls() == std::vector<std::string>{ "children", "replace_all" }));
+
+        // an initializer list is handed over as is, without being copied
+        FakeControl listPanel;
+        const std::initializer_list<std::shared_ptr<FakeElement>> list{ elements[2], elements[0] };
+        CHECK(CountCrossings([&] { Builder::AddChildren(listPanel, list); }) == 2);
+        CHECK(listPanel.state->replacedFrom == list.begin());
+        CHECK(listPanel.state->children.size() == 2);
+        CHECK(listPanel.state->children[0] == elements[2]);
+
+        // lazy views get iterated once
+        FakeControl viewPanel;
+        int calls = 0;
+        const std::vector<int> ids{ 5, 6 };
+        CountCrossings([&] {
+            Builder::AddChildren(viewPanel, cppxaml::utils::transform_view(ids, [&](int id) {
+                calls++;
+                return std::make_shared<FakeElement>(FakeElement{ std::to_wstring(id) });
+            }));
+        });
+        CHECK(calls == 2);
+        CHECK(viewPanel.state->children.size() == 2);
+        CHECK(viewPanel.state->children[1]->text == L"6");
+
+        // nothing to add, nothing to call
+        FakeControl empty;
+        CHECK(CountCrossings([&] { Builder::AddChildren(empty, std::vector<std::shared_ptr<FakeElement>>{}); }) == 0);
+        CHECK(CountCrossings([&] { Builder::AddChildren(empty, std::initializer_list<std::shared_ptr<FakeElement>>{}); }) == 0);
+    }
+
+    void TestGrid() {
+        const auto elements = MakeElements(4);
+        const auto placed = Place(elements, 2);
+        FakeControl grid;
+        const auto crossings = CountCrossings([&] { Builder::AddGridContents(grid, std::vector<double>{ 40, 1 }, std::vector<double>{ 2, 3 }, placed); });
+        // 2 per definition, 3 per placed child, and 2 per collection
+        CHECK(crossings == 4 * 2 + 4 * 3 + 3 * 2);
+        CHECK(cppxaml::details::BuilderStats().added == 8);
+        CHECK(grid.state->rows.size() == 2);
+        CHECK(grid.state->rows[0].length == 40);
+        CHECK(grid.state->columns[1].length == 3);
+        CHECK(grid.state->children == elements);
+        CHECK(elements[3]->row == 1);
+        CHECK(elements[3]->column == 1);
+        CHECK(elements[1]->row == 0);
+        CHECK(elements[1]->column == 1);
+
+        // plain elements aren't placed, and a grid without definitions doesn't get its definitions collections
+        FakeControl plain;
+        CHECK(CountCrossings([&] { Builder::AddGridContents(plain, std::vector<double>{}, std::vector<double>{}, elements); }) == 2);
+        CHECK(plain.state->children.size() == 4);
+        CHECK(plain.state->rows.empty());
+    }
+
+    void TestItems() {
+        FakeControl control;
+        const std::vector<int> values{ 1, 2, 3 };
+        // one box per item, and 2 for the collection
+        CHECK(CountCrossings([&] { Builder::AddItems(control, values); }) == 3 + 2);
+        CHECK(control.state->items.size() == 3);
+        CHECK(control.state->items[2].text == L"3");
+
+        // items that don't need boxing cost nothing each
+        FakeControl prebuilt;
+        const std::vector<FakeItem> items{ { L"a" }, { L"b" } };
+        CHECK(CountCrossings([&] { Builder::AddItems(prebuilt, items); }) == 2);
+        CHECK(prebuilt.state->items.size() == 2);
+    }
+
+    // Records the crossings made before and after batching, for the same content.
+    void TestBatchingSavings() {
+        constexpr size_t side = 10;
+        const std::vector<double> lengths(side, 1);
+        const auto elements = MakeElements(side * side);
+        const auto placed = Place(elements, static_cast<int>(side));
+        std::vector<int> values(side * side);
+        for (size_t i = 0; i < values.size(); i++) values[i] = static_cast<int>(i);
+
+        FakeControl appendPanel, batchPanel;
+        const auto panelBefore = CountCrossings([&] { AppendEachBuilder::AddChildren(appendPanel, elements); });
+        const auto panelAfter = CountCrossings([&] { Builder::AddChildren(batchPanel, elements); });
+        CHECK(appendPanel.state->children == batchPanel.state->children);
+
+        FakeControl appendGrid, batchGrid;
+        const auto gridBefore = CountCrossings([&] { AppendEachBuilder::AddGridContents(appendGrid, lengths, lengths, placed); });
+        const auto gridAfter = CountCrossings([&] { Builder::AddGridContents(batchGrid, lengths, lengths, placed); });
+        CHECK(appendGrid.state->children == batchGrid.state->children);
+        CHECK(appendGrid.state->rows.size() == batchGrid.state->rows.size());
+
+        FakeControl appendItems, batchItems;
+        const auto itemsBefore = CountCrossings([&] { AppendEachBuilder::AddItems(appendItems, values); });
+        const auto itemsAfter = CountCrossings([&] { Builder::AddItems(batchItems, values); });
+        CHECK(appendItems.state->items.size() == batchItems.state->items.size());
+
+        const size_t n = side * side;
+        // a getter and an Append per child
+        CHECK(panelBefore == 2 * n);
+        CHECK(panelAfter == 2);
+        // per definition: activation, setter, getter and Append; per child: getter, Append, 2 QueryInterface calls, SetRow and SetColumn
+        CHECK(gridBefore == 4 * 2 * side + 6 * n);
+        CHECK(gridAfter == 2 * 2 * side + 3 * n + 3 * 2);
+        // per item: box, getter and Append
+        CHECK(itemsBefore == 3 * n);
+        CHECK(itemsAfter == n + 2);
+
+        std::printf("crossings for %zu children: panel %llu -> %llu, %zux%zu grid %llu -> %llu, items control %llu -> %llu\n", n,
+            static_cast<unsigned long long>(panelBefore), static_cast<unsigned long long>(panelAfter), side, side,
+            static_cast<unsigned long long>(gridBefore), static_cast<unsigned long long>(gridAfter),
+            static_cast<unsigned long long>(itemsBefore), static_cast<unsigned long long>(itemsAfter));
+    }
+}
+
+int main() {
+    TestPanel();
+    TestGrid();
+    TestItems();
+    TestBatchingSavings();
+    return TEST_RESULT();
+}
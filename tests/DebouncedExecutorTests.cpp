@@ -0,0 +1,139 @@
+#include "test.h"
+#include <cppxaml/AsyncSearch.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using cppxaml::search::CancellationToken;
+using cppxaml::search::DebouncedExecutor;
+
+namespace {
+    // Records which jobs ran, and lets the test wait for them.
+    struct Log {
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::vector<int> ran;
+
+        void Add(int job) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ran.push_back(job);
+            }
+            changed.notify_all();
+        }
+
+        bool WaitFor(size_t count, std::chrono::milliseconds timeout = 5000ms) {
+            std::unique_lock<std::mutex> lock(mutex);
+            return changed.wait_for(lock, timeout, [&] { return ran.size() >= count; });
+        }
+
+        std::vector<int> Ran() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return ran;
+        }
+    };
+
+    void TestRunsJob() {
+        Log log;
+        DebouncedExecutor executor;
+        bool cancelled = true;
+        auto token = executor.Post([&](const CancellationToken& t) {
+            cancelled = t.IsCancelled();
+            log.Add(1);
+        });
+        CHECK(log.WaitFor(1));
+        CHECK(!cancelled);
+        CHECK(!token.IsCancelled());
+    }
+
+    void TestPostCancelsRunningJob() {
+        Log log;
+        DebouncedExecutor executor;
+        std::atomic<bool> started{ false };
+        std::atomic<bool> sawCancel{ false };
+        auto first = executor.Post([&](const CancellationToken& token) {
+            started = true;
+            const auto deadline = std::chrono::steady_clock::now() + 5s;
+            while (!token.IsCancelled() && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+            sawCancel = token.IsCancelled();
+            log.Add(1);
+        });
+        while (!started) {
+            std::this_thread::yield();
+        }
+        auto second = executor.Post([&](const CancellationToken&) { log.Add(2); });
+        CHECK(first.IsCancelled());
+        CHECK(!second.IsCancelled());
+        CHECK(log.WaitFor(2));
+        CHECK(sawCancel);
+        CHECK((log.Ran() == std::vector<int>{ 1, 2 }));
+    }
+
+    void TestDebounceRunsOnlyLastJob() {
+        Log log;
+        DebouncedExecutor executor(100ms);
+        std::vector<CancellationToken> tokens;
+        for (int job = 1; job <= 5; job++) {
+            tokens.push_back(executor.Post([&log, job](const CancellationToken&) { log.Add(job); }));
+            std::this_thread::sleep_for(10ms);
+        }
+        CHECK(log.WaitFor(1));
+        // give superseded jobs a chance to (wrongly) run
+        std::this_thread::sleep_for(200ms);
+        CHECK((log.Ran() == std::vector<int>{ 5 }));
+        for (size_t i = 0; i + 1 < tokens.size(); i++) {
+            CHECK(tokens[i].IsCancelled());
+        }
+        CHECK(!tokens.back().IsCancelled());
+    }
+
+    void TestDebounceWaitsForInputToSettle() {
+        Log log;
+        DebouncedExecutor executor(150ms);
+        std::chrono::steady_clock::time_point ranAt;
+        const auto postedAt = std::chrono::steady_clock::now();
+        executor.Post([&](const CancellationToken&) {
+            ranAt = std::chrono::steady_clock::now();
+            log.Add(1);
+        });
+        CHECK(log.WaitFor(1));
+        CHECK(ranAt - postedAt >= 150ms);
+        CHECK(executor.Debounce() == 150ms);
+    }
+
+    void TestCancel() {
+        Log log;
+        DebouncedExecutor executor(100ms);
+        auto token = executor.Post([&](const CancellationToken&) { log.Add(1); });
+        executor.Cancel();
+        CHECK(token.IsCancelled());
+        CHECK(!log.WaitFor(1, 300ms));
+    }
+
+    void TestTokenOutlivesExecutor() {
+        CancellationToken token;
+        CHECK(token.IsCancelled());
+        {
+            DebouncedExecutor executor(1000ms);
+            token = executor.Post([](const CancellationToken&) {});
+            CHECK(!token.IsCancelled());
+        }
+        CHECK(token.IsCancelled());
+    }
+}
+
+int main() {
+    TestRunsJob();
+    TestPostCancelsRunningJob();
+    TestDebounceRunsOnlyLastJob();
+    TestDebounceWaitsForInputToSettle();
+    TestCancel();
+    TestTokenOutlivesExecutor();
+    return TEST_RESULT();
+}
@@ -0,0 +1,128 @@
+// Builds 20k instances of a list row (a grid of 8 elements, with 13 property values), with fake elements that live on the heap.
+// The baseline re-runs builder code for each row: it boxes every value again, and appends children one at a time.
+// The template is built and flattened once, then stamped: the boxes are shared, and each parent gets its children in one call.
+#include "test.h"
+#include <cppxaml/ElementTemplate.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    struct FakeElement {
+        int type{};
+        std::vector<std::pair<int, std::shared_ptr<const std::wstring>>> properties;
+        std::vector<std::shared_ptr<FakeElement>> children;
+    };
+
+    struct FakeTraits {
+        using type_t = int;
+        using property_t = int;
+        using value_t = std::shared_ptr<const std::wstring>;
+        using object_t = std::shared_ptr<FakeElement>;
+
+        template<typename V>
+        static value_t make_value(V&& value) {
+            return std::make_shared<const std::wstring>(std::forward<V>(value));
+        }
+
+        static object_t create(int type) {
+            auto element = std::make_shared<FakeElement>();
+            element->type = type;
+            return element;
+        }
+
+        static void set(const object_t& element, int property, const value_t& value) {
+            element->properties.emplace_back(property, value);
+        }
+
+        static void append_children(const object_t& parent, const object_t* children, size_t count) {
+            parent->children.insert(parent->children.end(), children, children + count);
+        }
+    };
+
+    using Spec = cppxaml::templates::ElementSpec<FakeTraits>;
+    using Template = cppxaml::templates::ElementTemplate<FakeTraits>;
+
+    enum Type { Grid, StackPanel, TextBlock, Image, Button };
+    enum Property { Row, Column, Text, Margin, Width, Source, Orientation };
+
+    Spec RowSpec() {
+        return Spec(Grid).Set(Margin, L"4").Children({
+            Spec(Image).Set(Source, L"ms-appx:///icon.png").Set(Width, L"32"),
+            Spec(StackPanel).Set(Column, L"1").Set(Orientation, L"Vertical").Children({
+                Spec(TextBlock).Set(Text, L"Title"),
+                Spec(TextBlock).Set(Text, L"Subtitle").Set(Margin, L"0,2,0,0"),
+            }),
+            Spec(StackPanel).Set(Column, L"2").Children({
+                Spec(Button).Set(Text, L"Edit").Set(Width, L"80"),
+                Spec(Button).Set(Text, L"Delete").Set(Width, L"80"),
+            }),
+        });
+    }
+
+    // what builder code does for each row
+    FakeTraits::object_t BuildRow() {
+        auto element = [](int type, std::initializer_list<std::pair<int, const wchar_t*>> properties) {
+            auto e = FakeTraits::create(type);
+            for (auto& [property, value] : properties) {
+                FakeTraits::set(e, property, FakeTraits::make_value(value));
+            }
+            return e;
+        };
+        auto append = [](const FakeTraits::object_t& parent, std::initializer_list<FakeTraits::object_t> children) {
+            for (auto& child : children) {
+                FakeTraits::append_children(parent, &child, 1);
+            }
+        };
+        auto grid = element(Grid, { { Margin, L"4" } });
+        auto labels = element(StackPanel, { { Column, L"1" }, { Orientation, L"Vertical" } });
+        append(labels, { element(TextBlock, { { Text, L"Title" } }), element(TextBlock, { { Text, L"Subtitle" }, { Margin, L"0,2,0,0" } }) });
+        auto buttons = element(StackPanel, { { Column, L"2" } });
+        append(buttons, { element(Button, { { Text, L"Edit" }, { Width, L"80" } }), element(Button, { { Text, L"Delete" }, { Width, L"80" } }) });
+        append(grid, { element(Image, { { Source, L"ms-appx:///icon.png" }, { Width, L"32" } }), labels, buttons });
+        return grid;
+    }
+
+    size_t CountElements(const FakeTraits::object_t& e) {
+        size_t n = 1;
+        for (auto& child : e->children) {
+            n += CountElements(child);
+        }
+        return n;
+    }
+}
+
+int main() {
+    constexpr size_t count = 20000;
+
+    std::vector<FakeTraits::object_t> built, stamped;
+    const auto builderMs = cppxaml_tests::MeasureMs([&] {
+        built.clear();
+        built.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            built.push_back(BuildRow());
+        }
+    });
+
+    size_t instructions = 0;
+    const auto flattenMs = cppxaml_tests::MeasureMs([&] {
+        const Template row(RowSpec());
+        instructions = row.InstructionCount();
+    });
+    const Template row(RowSpec());
+    const auto stampMs = cppxaml_tests::MeasureMs([&] { stamped = row.Instantiate(count); });
+
+    std::printf("%zu rows of %zu elements, %zu instructions per row\n", count, row.ElementCount(), instructions);
+    std::printf("re-run builder:      %8.2f ms\n", builderMs);
+    std::printf("build template once: %8.3f ms\n", flattenMs);
+    std::printf("stamp template:      %8.2f ms\n", stampMs);
+
+    CHECK(built.size() == count && stamped.size() == count);
+    CHECK(CountElements(built.front()) == row.ElementCount() && CountElements(stamped.back()) == row.ElementCount());
+    // stamped rows share their boxes
+    CHECK(stamped.front()->properties[0].second == stamped.back()->properties[0].second);
+    CHECK(*stamped.back()->children[2]->children[1]->properties[0].second == L"Delete");
+    return TEST_RESULT();
+}
@@ -0,0 +1,191 @@
+#include "test.h"
+#include <cppxaml/ElementTemplate.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    struct FakeElement {
+        std::string type;
+        std::map<std::string, std::shared_ptr<const std::string>> properties;
+        std::vector<std::shared_ptr<FakeElement>> children;
+        // how many children the element had when each initializer ran
+        std::vector<size_t> childrenWhenInitialized;
+    };
+
+    // Elements are plain objects, and values are "boxed" into shared strings, so that tests can tell whether instances share a box.
+    struct FakeTraits {
+        using type_t = std::string;
+        using property_t = std::string;
+        using value_t = std::shared_ptr<const std::string>;
+        using object_t = std::shared_ptr<FakeElement>;
+
+        template<typename V>
+        static value_t make_value(V&& value) {
+            boxes++;
+            return std::make_shared<const std::string>(std::forward<V>(value));
+        }
+
+        static object_t create(const type_t& type) {
+            created++;
+            auto element = std::make_shared<FakeElement>();
+            element->type = type;
+            return element;
+        }
+
+        static void set(const object_t& element, const property_t& property, const value_t& value) {
+            element->properties[property] = value;
+        }
+
+        static void append_children(const object_t& parent, const object_t* children, size_t count) {
+            appendCalls++;
+            parent->children.insert(parent->children.end(), children, children + count);
+        }
+
+        static inline int boxes = 0;
+        static inline int created = 0;
+        static inline int appendCalls = 0;
+
+        static void Reset() {
+            boxes = created = appendCalls = 0;
+        }
+    };
+
+    using Spec = cppxaml::templates::ElementSpec<FakeTraits>;
+    using Template = cppxaml::templates::ElementTemplate<FakeTraits>;
+
+    Spec Element(std::string type) {
+        return Spec(std::move(type));
+    }
+
+    std::string Get(const FakeTraits::object_t& element, const std::string& property) {
+        auto it = element->properties.find(property);
+        return it != element->properties.end() ? *it->second : "<unset>";
+    }
+
+    void RecordChildren(const FakeTraits::object_t& element) {
+        element->childrenWhenInitialized.push_back(element->children.size());
+    }
+
+    // StackPanel
+    //   TextBlock  Text=Name
+    //   TextBox    Width=200, initialized
+    //   StackPanel Orientation=Vertical
+    //     Image    Source=icon.png
+    //     TextBlock Text=caption, Margin=4
+    Spec RowSpec() {
+        return Element("StackPanel")
+            .Set("Orientation", "Horizontal")
+            .Initialize(RecordChildren)
+            .Children({
+                Element("TextBlock").Set("Text", "Name"),
+                Element("TextBox").Set("Width", "200").Initialize(RecordChildren),
+                Element("StackPanel").Set("Orientation", "Vertical").Children({
+                    Element("Image").Set("Source", "icon.png"),
+                    Element("TextBlock").Set("Text", "caption").Set("Margin", "4"),
+                }),
+            });
+    }
+
+    void CheckRow(const FakeTraits::object_t& row) {
+        CHECK(row->type == "StackPanel");
+        CHECK(Get(row, "Orientation") == "Horizontal");
+        CHECK(row->childrenWhenInitialized == std::vector<size_t>{ 0 });
+        CHECK(row->children.size() == 3);
+        if (row->children.size() != 3) return;
+
+        const auto& text = row->children[0];
+        CHECK(text->type == "TextBlock" && Get(text, "Text") == "Name" && text->children.empty());
+        const auto& box = row->children[1];
+        CHECK(box->type == "TextBox" && Get(box, "Width") == "200" && box->properties.size() == 1);
+        CHECK(box->childrenWhenInitialized.size() == 1);
+        const auto& inner = row->children[2];
+        CHECK(inner->type == "StackPanel" && Get(inner, "Orientation") == "Vertical");
+        CHECK(inner->childrenWhenInitialized.empty());
+        CHECK(inner->children.size() == 2);
+        if (inner->children.size() != 2) return;
+        CHECK(inner->children[0]->type == "Image" && Get(inner->children[0], "Source") == "icon.png");
+        CHECK(inner->children[1]->type == "TextBlock" && Get(inner->children[1], "Text") == "caption" && Get(inner->children[1], "Margin") == "4");
+    }
+
+    void TestStamping() {
+        FakeTraits::Reset();
+        const Template row(RowSpec());
+        // values are boxed once, when the spec is built
+        CHECK(FakeTraits::boxes == 7);
+        CHECK(row.ElementCount() == 6);
+        // 6 creates, 7 sets, 2 initializers, 2 appends
+        CHECK(row.InstructionCount() == 17);
+        CHECK(FakeTraits::created == 0);
+
+        const auto rows = row.Instantiate(3);
+        CHECK(rows.size() == 3);
+        for (const auto& r : rows) {
+            CheckRow(r);
+        }
+        CHECK(FakeTraits::boxes == 7);
+        CHECK(FakeTraits::created == 18);
+        // each parent gets all of its children in one call
+        CHECK(FakeTraits::appendCalls == 6);
+
+        // instances are distinct elements...
+        CHECK(rows[0] != rows[1] && rows[0]->children[2] != rows[1]->children[2]);
+        // ...that share the boxed values
+        CHECK(rows[0]->properties["Orientation"] == rows[2]->properties["Orientation"]);
+        CHECK(rows[0]->children[2]->children[1]->properties["Margin"] == rows[1]->children[2]->children[1]->properties["Margin"]);
+        CHECK(rows[0]->properties["Orientation"] != rows[0]->children[2]->properties["Orientation"]);
+
+        CheckRow(row.Instantiate());
+        CHECK(FakeTraits::created == 24);
+    }
+
+    void TestSpecIsAValue() {
+        FakeTraits::Reset();
+        auto spec = Element("Grid").Set("Background", "red");
+        const Template before(spec);
+        spec.Child(Element("Button"));
+        const Template after(spec);
+        CHECK(before.Instantiate()->children.empty());
+        CHECK(after.Instantiate()->children.size() == 1);
+        // copies of the spec share its boxes
+        CHECK(FakeTraits::boxes == 1);
+    }
+
+    void TestLeafAndDeepTrees() {
+        const Template leaf(Element("Border"));
+        CHECK(leaf.ElementCount() == 1 && leaf.InstructionCount() == 1);
+        CHECK(leaf.Instantiate()->type == "Border");
+
+        // a chain of nested elements, and a wide element
+        auto chain = Element("Leaf");
+        for (int i = 0; i < 50; i++) {
+            chain = Element("Border").Child(std::move(chain));
+        }
+        auto wide = Element("StackPanel");
+        for (int i = 0; i < 50; i++) {
+            wide.Child(Element("TextBlock").Set("Text", std::to_string(i)));
+        }
+        const auto deep = Template(chain).Instantiate();
+        auto element = deep;
+        int depth = 0;
+        while (!element->children.empty()) {
+            CHECK(element->children.size() == 1);
+            element = element->children[0];
+            depth++;
+        }
+        CHECK(depth == 50 && element->type == "Leaf");
+        const auto panel = Template(wide).Instantiate();
+        CHECK(panel->children.size() == 50);
+        for (size_t i = 0; i < panel->children.size(); i++) {
+            CHECK(Get(panel->children[i], "Text") == std::to_string(i));
+        }
+    }
+}
+
+int main() {
+    TestStamping();
+    TestSpecIsAValue();
+    TestLeafAndDeepTrees();
+    return TEST_RESULT();
+}
@@ -0,0 +1,58 @@
+// Solves dashboard-like grids with thousands of cells: a mix of pixel, Auto and star tracks, with some children spanning several tracks.
+#include "test.h"
+#include <cppxaml/GridLayout.h>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace cppxaml::layout;
+
+namespace {
+    std::vector<GridTrack> MakeTracks(size_t count) {
+        std::vector<GridTrack> tracks;
+        for (size_t i = 0; i < count; i++) {
+            switch (i % 4) {
+            case 0: tracks.emplace_back(GridLength::Pixels(48)); break;
+            case 1: tracks.emplace_back(GridLength::Auto()); break;
+            case 2: tracks.emplace_back(GridLength::Star(), 20, 400); break;
+            default: tracks.emplace_back(GridLength::Star(2)); break;
+            }
+        }
+        return tracks;
+    }
+
+    std::vector<GridCell> MakeCells(size_t rows, size_t columns) {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> size(10, 200);
+        std::uniform_int_distribution<int> span(0, 9);
+        std::vector<GridCell> cells;
+        cells.reserve(rows * columns);
+        for (size_t r = 0; r < rows; r++) {
+            for (size_t c = 0; c < columns; c++) {
+                // one child in ten spans two or three tracks
+                const size_t s = span(rng) == 0 ? 2 + (r + c) % 2 : 1;
+                cells.push_back({ r, c, s, s, { size(rng), size(rng) } });
+            }
+        }
+        return cells;
+    }
+}
+
+int main() {
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+    for (const auto& [rows, columns] : { std::pair<size_t, size_t>{ 50, 20 }, std::pair<size_t, size_t>{ 100, 100 } }) {
+        const auto rowTracks = MakeTracks(rows);
+        const auto columnTracks = MakeTracks(columns);
+        const auto cells = MakeCells(rows, columns);
+        for (const Size available : { Size{ 1920, 1080 }, Size{ 1920, infinity } }) {
+            GridLayout layout;
+            const auto ms = cppxaml_tests::MeasureMs([&] { layout = SolveGrid(rowTracks, columnTracks, cells, available); }, 20);
+            CHECK(layout.rowHeights.size() == rows && layout.columnWidths.size() == columns);
+            CHECK(layout.desired.width > 0 && layout.desired.height > 0);
+            std::printf("%3zu x %3zu grid (%5zu cells), %s height: %.3f ms per solve\n",
+                rows, columns, cells.size(), available.height == infinity ? "infinite" : "  finite", ms);
+        }
+    }
+    return TEST_RESULT();
+}
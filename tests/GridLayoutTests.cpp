@@ -0,0 +1,120 @@
+#include "test.h"
+#include <cppxaml/GridLayout.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace cppxaml::layout;
+using namespace cppxaml::layout::literals;
+
+namespace {
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+
+    bool Near(double a, double b) {
+        return std::abs(a - b) < 1e-9;
+    }
+
+    bool Near(const std::vector<double>& a, const std::vector<double>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); i++) {
+            if (!Near(a[i], b[i])) return false;
+        }
+        return true;
+    }
+
+    GridCell Cell(size_t row, size_t column, double width, double height, size_t rowSpan = 1, size_t columnSpan = 1) {
+        return { row, column, rowSpan, columnSpan, { width, height } };
+    }
+
+    void TestPixelAutoStar() {
+        const std::vector<GridCell> cells{ Cell(0, 1, 50, 30) };
+        const auto layout = SolveGrid("40, Auto, *"_rows, "100, Auto, 2*, *"_cols, cells, { 700, 400 });
+        CHECK(Near(layout.rowHeights, { 40, 0, 360 }));
+        CHECK(Near(layout.columnWidths[0], 100));
+        CHECK(Near(layout.columnWidths[1], 50));
+        CHECK(Near(layout.columnWidths[2], 2 * 550.0 / 3));
+        CHECK(Near(layout.columnWidths[3], 550.0 / 3));
+        CHECK(Near(layout.columnOffsets, { 0, 100, 150, 150 + 2 * 550.0 / 3 }));
+        CHECK(Near(layout.desired.width, 150));
+        CHECK(Near(layout.desired.height, 40));
+        const auto rect = layout.CellRect(cells[0]);
+        CHECK(Near(rect.x, 100) && Near(rect.y, 0) && Near(rect.width, 50) && Near(rect.height, 40));
+    }
+
+    void TestStarBounds() {
+        const std::vector<GridTrack> columns{ GridTrack(GridLength::Star(), 0, 100), GridTrack(GridLength::Star()), GridTrack(GridLength::Star(), 300) };
+        const auto layout = SolveGrid("*"_rows, columns, std::vector<GridCell>{}, { 600, 100 });
+        CHECK(Near(layout.columnWidths, { 100, 200, 300 }));
+    }
+
+    void TestStarContentDesired() {
+        // a star column's content counts toward the desired size at the star's proportion
+        const std::vector<GridCell> cells{ Cell(0, 0, 100, 10) };
+        const auto layout = SolveGrid("*"_rows, "*, 3*"_cols, cells, { 1000, 100 });
+        CHECK(Near(layout.desired.width, 400));
+        CHECK(Near(layout.columnWidths, { 250, 750 }));
+    }
+
+    void TestSpanGrowsAutos() {
+        const std::vector<GridCell> cells{ Cell(0, 0, 40, 10), Cell(1, 0, 100, 10, 1, 2) };
+        const auto layout = SolveGrid("Auto, Auto"_rows, "Auto, Auto, *"_cols, cells, { 500, 500 });
+        CHECK(Near(layout.columnWidths, { 70, 30, 400 }));
+        CHECK(Near(layout.desired.width, 100));
+    }
+
+    void TestSpanIntoStar() {
+        // the spanning child doesn't fit in the Auto column, so the star column has to make up the rest
+        const std::vector<GridCell> cells{ Cell(0, 0, 120, 32), Cell(1, 0, 300, 20, 1, 2) };
+        const auto layout = SolveGrid("Auto, *"_rows, "Auto, *"_cols, cells, { 800, 600 });
+        CHECK(Near(layout.desired.width, 300));
+        CHECK(Near(layout.columnWidths, { 120, 680 }));
+        CHECK(Near(layout.desired.height, 52));
+
+        // a span that the other tracks already hold doesn't grow the stars
+        const std::vector<GridCell> narrow{ Cell(0, 0, 120, 32), Cell(1, 0, 100, 20, 1, 2) };
+        CHECK(Near(SolveGrid("Auto, *"_rows, "Auto, *"_cols, narrow, { 800, 600 }).desired.width, 120));
+
+        // the excess is shared by the spanned stars by weight
+        const std::vector<GridCell> weighted{ Cell(0, 0, 300, 10, 1, 3) };
+        const auto layout2 = SolveGrid("*"_rows, "60, *, 2*"_cols, weighted, { 1000, 100 });
+        CHECK(Near(layout2.desired.width, 300));
+    }
+
+    void TestInfiniteStarsAreAuto() {
+        const std::vector<GridCell> cells{ Cell(0, 0, 80, 10), Cell(0, 1, 20, 50) };
+        const auto layout = SolveGrid("*"_rows, "*, *"_cols, cells, { infinity, infinity });
+        CHECK(Near(layout.columnWidths, { 80, 20 }));
+        CHECK(Near(layout.rowHeights, { 50 }));
+        CHECK(Near(layout.desired.width, 100));
+    }
+
+    void TestClampedRanges() {
+        // out of range rows, columns and spans get clamped
+        const std::vector<GridCell> cells{ Cell(5, 7, 30, 30, 3, 4) };
+        const auto layout = SolveGrid("Auto, Auto"_rows, "Auto, Auto"_cols, cells, { 100, 100 });
+        CHECK(Near(layout.rowHeights, { 0, 30 }));
+        CHECK(Near(layout.columnWidths, { 0, 30 }));
+        const auto rect = layout.CellRect(cells[0]);
+        CHECK(Near(rect.x, 0) && Near(rect.y, 0) && Near(rect.width, 30) && Near(rect.height, 30));
+    }
+
+    void TestNoDefinitions() {
+        const std::vector<GridCell> cells{ Cell(0, 0, 30, 40) };
+        const auto layout = SolveGrid(std::vector<GridLength>{}, std::vector<GridLength>{}, cells, { 200, 100 });
+        CHECK(Near(layout.columnWidths, { 200 }));
+        CHECK(Near(layout.rowHeights, { 100 }));
+        CHECK(Near(layout.desired.width, 30) && Near(layout.desired.height, 40));
+    }
+}
+
+int main() {
+    TestPixelAutoStar();
+    TestStarBounds();
+    TestStarContentDesired();
+    TestSpanGrowsAutos();
+    TestSpanIntoStar();
+    TestInfiniteStarsAreAuto();
+    TestClampedRanges();
+    TestNoDefinitions();
+    return TEST_RESULT();
+}
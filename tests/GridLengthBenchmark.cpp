@@ -0,0 +1,57 @@
+// Parses the row and column specs of many grids, as the Grid builder does when a view is built.
+// The baseline copies each token into a wide string and parses it with wcstod, which is what handing every token to the XAML type converter costs at a minimum
+// (the converter also boxes the string and crosses the ABI, which can't be measured here).
+#include "test.h"
+#include <cppxaml/Layout.h>
+#include <cstdio>
+#include <cwchar>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace cppxaml::layout;
+
+namespace {
+    GridLength ParseWithWcstod(std::string_view token) {
+        std::wstring text(token.begin(), token.end());
+        while (!text.empty() && text.back() == L' ') text.pop_back();
+        while (!text.empty() && text.front() == L' ') text.erase(text.begin());
+        if (text == L"Auto" || text == L"auto") {
+            return GridLength::Auto();
+        }
+        if (!text.empty() && text.back() == L'*') {
+            text.pop_back();
+            return GridLength::Star(text.empty() ? 1 : std::wcstod(text.c_str(), nullptr));
+        }
+        return GridLength::Pixels(std::wcstod(text.c_str(), nullptr));
+    }
+
+    template<typename Parse>
+    std::vector<GridLength> ParseAll(const std::vector<std::string>& specs, Parse&& parse) {
+        std::vector<GridLength> lengths;
+        for (const auto& spec : specs) {
+            ForEachGridLengthToken(std::string_view(spec), [&](std::string_view token) { lengths.push_back(parse(token)); });
+        }
+        return lengths;
+    }
+}
+
+int main() {
+    const char* shapes[] = { "40, *", "Auto, Auto", "Auto, *, Auto", "48, 2*, *, 120", "0.5*, 0.5*", "Auto, 12.5, *, 3*, Auto, 200" };
+    std::vector<std::string> specs;
+    for (size_t i = 0; i < 200000; i++) {
+        specs.push_back(shapes[i % std::size(shapes)]);
+    }
+
+    std::vector<GridLength> native, baseline;
+    const auto nativeMs = cppxaml_tests::MeasureMs([&] {
+        native = ParseAll(specs, [](std::string_view token) { return ParseGridLength(token).value_or(GridLength::Star(-1)); });
+    });
+    const auto baselineMs = cppxaml_tests::MeasureMs([&] { baseline = ParseAll(specs, ParseWithWcstod); });
+
+    std::printf("%zu specs, %zu lengths\n", specs.size(), native.size());
+    std::printf("ParseGridLength:      %8.2f ms\n", nativeMs);
+    std::printf("wstring + wcstod:     %8.2f ms\n", baselineMs);
+    CHECK(native == baseline);
+    return TEST_RESULT();
+}
@@ -0,0 +1,172 @@
+#include "test.h"
+#include <cppxaml/Layout.h>
+#include <cstdlib>
+#include <cwchar>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace cppxaml::layout;
+
+namespace {
+    template<typename CharT>
+    std::vector<std::basic_string<CharT>> Tokens(std::basic_string_view<CharT> s) {
+        std::vector<std::basic_string<CharT>> tokens;
+        ForEachGridLengthToken(s, [&tokens](std::basic_string_view<CharT> token) { tokens.emplace_back(token); });
+        return tokens;
+    }
+
+    // Parses a whole list the way the Grid builder does, and fails if any token is malformed.
+    template<typename CharT>
+    std::optional<std::vector<GridLength>> ParseList(std::basic_string_view<CharT> s) {
+        std::vector<GridLength> lengths;
+        bool ok = true;
+        ForEachGridLengthToken(s, [&](std::basic_string_view<CharT> token) {
+            if (auto length = ParseGridLength(token)) {
+                lengths.push_back(*length);
+            }
+            else {
+                ok = false;
+            }
+        });
+        if (!ok) return std::nullopt;
+        return lengths;
+    }
+
+    std::optional<GridLength> Parse(std::string_view s) {
+        return ParseGridLength(s);
+    }
+
+    std::optional<GridLength> Parse(std::wstring_view s) {
+        return ParseGridLength(s);
+    }
+
+    void TestAuto() {
+        CHECK(Parse("Auto") == GridLength::Auto());
+        CHECK(Parse("auto") == GridLength::Auto());
+        CHECK(Parse("AUTO") == GridLength::Auto());
+        CHECK(Parse("  aUtO\t") == GridLength::Auto());
+        CHECK(!Parse("Aut"));
+        CHECK(!Parse("Autos"));
+        CHECK(!Parse("Au to"));
+    }
+
+    void TestStar() {
+        CHECK(Parse("*") == GridLength::Star());
+        CHECK(Parse("2*") == GridLength::Star(2));
+        CHECK(Parse("0*") == GridLength::Star(0));
+        CHECK(Parse("0.25*") == GridLength::Star(0.25));
+        CHECK(Parse(".5*") == GridLength::Star(0.5));
+        CHECK(Parse("3.*") == GridLength::Star(3));
+        CHECK(Parse(" 2* ") == GridLength::Star(2));
+        CHECK(!Parse("**"));
+        CHECK(!Parse("2**"));
+        CHECK(!Parse("*2"));
+        CHECK(!Parse("2 *"));
+        CHECK(!Parse(".*"));
+        CHECK(!Parse("-1*"));
+    }
+
+    void TestPixels() {
+        CHECK(Parse("40") == GridLength::Pixels(40));
+        CHECK(Parse("0") == GridLength::Pixels(0));
+        CHECK(Parse("007") == GridLength::Pixels(7));
+        CHECK(Parse("12.5") == GridLength::Pixels(12.5));
+        CHECK(Parse("\r\n 40 \n") == GridLength::Pixels(40));
+        CHECK(!Parse("4 0"));
+        CHECK(!Parse("1.2.3"));
+        CHECK(!Parse("."));
+        CHECK(!Parse("+40"));
+        CHECK(!Parse("-40"));
+        // left to the XAML converter
+        CHECK(!Parse("1e3"));
+        CHECK(!Parse("1in"));
+        CHECK(!Parse("12345678901234567890"));
+    }
+
+    void TestEmptyAndMalformed() {
+        CHECK(!Parse(""));
+        CHECK(!Parse("   "));
+        CHECK(!Parse(","));
+        CHECK(!Parse("x"));
+        CHECK(!Parse("40px"));
+    }
+
+    // Every decimal with few enough digits parses to the same double as the C library would produce.
+    void TestDecimalsMatchStrtod() {
+        std::mt19937 random(15);
+        for (int i = 0; i < 20000; i++) {
+            const auto integer = std::to_string(random() % 100000);
+            auto fraction = std::to_string(random() % 10000000);
+            fraction.insert(0, random() % 4, '0');
+            const auto text = integer + "." + fraction;
+            const auto parsed = Parse(text);
+            CHECK(parsed && parsed->unit == GridUnit::Pixel);
+            if (parsed && parsed->value != std::strtod(text.c_str(), nullptr)) {
+                std::fprintf(stderr, "%s parsed as %.17g\n", text.c_str(), parsed->value);
+                CHECK(false);
+            }
+        }
+    }
+
+    void TestWideMatchesNarrow() {
+        const char* inputs[] = { "Auto", " auto ", "*", "2*", "0.5*", "40", "12.75", "", " ", "1in", "x*", "4 0", "1e3" };
+        for (auto input : inputs) {
+            const std::string narrow(input);
+            const std::wstring wide(narrow.begin(), narrow.end());
+            CHECK(Parse(narrow) == Parse(wide));
+        }
+        CHECK(Parse(std::wstring_view(L"\u0661")) == std::nullopt); // Arabic-Indic digit one
+        CHECK(Parse(std::wstring_view(L"\uff14\uff10")) == std::nullopt); // fullwidth "40"
+    }
+
+    void TestTokens() {
+        CHECK(Tokens(std::string_view("")).empty());
+        CHECK((Tokens(std::string_view("40")) == std::vector<std::string>{ "40" }));
+        CHECK((Tokens(std::string_view("40, *, Auto")) == std::vector<std::string>{ "40", " *", " Auto" }));
+        CHECK((Tokens(std::string_view("40,")) == std::vector<std::string>{ "40", "" }));
+        CHECK((Tokens(std::string_view(",40")) == std::vector<std::string>{ "", "40" }));
+        CHECK((Tokens(std::string_view("40,,*")) == std::vector<std::string>{ "40", "", "*" }));
+        CHECK((Tokens(std::string_view(",")) == std::vector<std::string>{ "", "" }));
+        CHECK((Tokens(std::wstring_view(L"Auto,2*")) == std::vector<std::wstring>{ L"Auto", L"2*" }));
+    }
+
+    void TestLists() {
+        const auto lengths = ParseList(std::string_view("40, *, Auto, 2.5*"));
+        CHECK(lengths && (*lengths == std::vector<GridLength>{ GridLength::Pixels(40), GridLength::Star(), GridLength::Auto(), GridLength::Star(2.5) }));
+        CHECK(ParseList(std::wstring_view(L" Auto , 10 ")) == (std::vector<GridLength>{ GridLength::Auto(), GridLength::Pixels(10) }));
+        CHECK(ParseList(std::string_view("")) == std::vector<GridLength>{});
+        // a trailing, leading or doubled comma leaves an empty token, which is malformed
+        CHECK(!ParseList(std::string_view("40,")));
+        CHECK(!ParseList(std::string_view("40, *,")));
+        CHECK(!ParseList(std::string_view("40, *, ")));
+        CHECK(!ParseList(std::string_view(",40")));
+        CHECK(!ParseList(std::string_view("40,,*")));
+        CHECK(!ParseList(std::wstring_view(L"Auto,")));
+        CHECK(!ParseList(std::string_view("40; *")));
+    }
+
+    constexpr size_t CountTokens(std::string_view s) {
+        size_t n = 0;
+        ForEachGridLengthToken(s, [&n](std::string_view) { n++; });
+        return n;
+    }
+
+    static_assert(CountTokens("") == 0);
+    static_assert(CountTokens("40, *") == 2);
+    static_assert(CountTokens("40, *,") == 3);
+    static_assert(ParseGridLength(std::string_view("0.5*")) == GridLength::Star(0.5));
+    static_assert(ParseGridLength(std::wstring_view(L"12")) == GridLength::Pixels(12));
+}
+
+int main() {
+    TestAuto();
+    TestStar();
+    TestPixels();
+    TestEmptyAndMalformed();
+    TestDecimalsMatchStrtod();
+    TestWideMatchesNarrow();
+    TestTokens();
+    TestLists();
+    return TEST_RESULT();
+}
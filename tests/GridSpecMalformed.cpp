@@ -0,0 +1,26 @@
+// Each GRID_SPEC_CASE but 0 must fail to compile; see tests/CMakeLists.txt.
+#include <cppxaml/Layout.h>
+
+using namespace cppxaml::layout::literals;
+
+int main() {
+#if GRID_SPEC_CASE == 0
+    // the control case, which makes sure that the others fail only because of their spec
+    constexpr auto spec = "40, *, Auto"_rows;
+#elif GRID_SPEC_CASE == 1
+    constexpr auto spec = "40, *,"_rows;
+#elif GRID_SPEC_CASE == 2
+    constexpr auto spec = "40,"_cols;
+#elif GRID_SPEC_CASE == 3
+    constexpr auto spec = ",40"_rows;
+#elif GRID_SPEC_CASE == 4
+    constexpr auto spec = "40,,*"_cols;
+#elif GRID_SPEC_CASE == 5
+    constexpr auto spec = "40, x"_rows;
+#elif GRID_SPEC_CASE == 6
+    constexpr auto spec = "1in"_cols;
+#elif GRID_SPEC_CASE == 7
+    constexpr auto spec = " "_rows;
+#endif
+    return static_cast<int>(spec.size());
+}
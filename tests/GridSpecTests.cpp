@@ -0,0 +1,53 @@
+#include "test.h"
+#include <cppxaml/Layout.h>
+#include <type_traits>
+
+using namespace cppxaml::layout;
+using namespace cppxaml::layout::literals;
+
+namespace {
+    template<GridAxis Axis, size_t N>
+    constexpr bool Equals(const GridSpec<Axis, N>& spec, const std::array<GridLength, N>& expected) {
+        for (size_t i = 0; i < N; i++) {
+            if (spec.lengths[i] != expected[i]) return false;
+        }
+        return true;
+    }
+
+    constexpr auto rows = "40, *, Auto"_rows;
+    constexpr auto columns = "Auto, 2.5*"_cols;
+
+    static_assert(rows.size() == 3);
+    static_assert(columns.size() == 2);
+    static_assert("*"_rows.size() == 1);
+    static_assert(""_rows.size() == 0); // like an empty string spec: the grid gets XAML's implicit single row
+    static_assert(" Auto , Auto , Auto , Auto "_cols.size() == 4);
+    static_assert(rows.axis() == GridAxis::Rows);
+    static_assert(columns.axis() == GridAxis::Columns);
+    static_assert(Equals(rows, { GridLength::Pixels(40), GridLength::Star(), GridLength::Auto() }));
+    static_assert(Equals(columns, { GridLength::Auto(), GridLength::Star(2.5) }));
+
+    // rows and columns are distinct types, so Grid can't take one for the other
+    static_assert(!std::is_same_v<decltype("40, *"_rows), decltype("40, *"_cols)>);
+    static_assert(std::is_same_v<decltype("40, *"_rows), GridSpec<GridAxis::Rows, 2>>);
+    static_assert(std::is_same_v<decltype("40, *"_cols), GridSpec<GridAxis::Columns, 2>>);
+    static_assert(!std::is_convertible_v<GridSpec<GridAxis::Rows, 2>, GridSpec<GridAxis::Columns, 2>>);
+
+    // the lengths live in the spec itself
+    static_assert(sizeof(rows) == 3 * sizeof(GridLength));
+    static_assert(std::is_trivially_copyable_v<std::remove_const_t<decltype(rows)>>);
+
+    void TestIteration() {
+        size_t n = 0;
+        for (const auto& length : rows) {
+            CHECK(length == rows.lengths[n]);
+            n++;
+        }
+        CHECK(n == 3);
+    }
+}
+
+int main() {
+    TestIteration();
+    return TEST_RESULT();
+}
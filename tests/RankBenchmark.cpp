@@ -0,0 +1,57 @@
+// Types a query into a ranked search over a 500k-item catalog, one keystroke at a time, and measures each keystroke.
+// Few items contain the query, so each keystroke also looks for fuzzy matches: the baseline scores every item of the catalog for them,
+// while SubstringIndex::FindRanked only scores the candidates that contain the query's rarest character, up to its budget.
+#include "test.h"
+#include <cppxaml/Search.h>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace cppxaml::search;
+namespace search = cppxaml::search;
+
+namespace {
+    std::vector<std::wstring> MakeCatalog(size_t count) {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> length(8, 40);
+        std::uniform_int_distribution<int> letter(0, 51);
+        std::vector<std::wstring> items(count);
+        for (auto& item : items) {
+            item.resize(static_cast<size_t>(length(rng)));
+            for (auto& c : item) {
+                const auto l = letter(rng);
+                c = static_cast<wchar_t>(l < 26 ? L'a' + l : L'A' + (l - 26));
+            }
+        }
+        return items;
+    }
+}
+
+int main() {
+    const SubstringIndex index(MakeCatalog(500000), true);
+    std::vector<id_t> all(index.size());
+    for (id_t id = 0; id < all.size(); id++) {
+        all[id] = id;
+    }
+
+    constexpr size_t maxResults = 20;
+    const std::wstring typed = L"xqzjv";
+    for (size_t length = 1; length <= typed.size(); length++) {
+        const auto query = index.Fold(std::wstring_view(typed).substr(0, length));
+        const auto matches = index.FindFolded(query);
+        std::vector<id_t> expected, actual;
+        const auto everyItem = cppxaml_tests::MeasureMs([&] { expected = search::Rank(index.Items(), query, matches, all, maxResults); });
+        const auto candidates = cppxaml_tests::MeasureMs([&] { actual = index.RankFolded(query, matches, maxResults); });
+        // with enough substring matches, neither looks for fuzzy matches
+        const auto fuzzyScored = matches.size() < maxResults ? index.FuzzyCandidates(query).size() : 0;
+        std::printf("keystroke %-6ls %6zu substring matches, %4zu fuzzy candidates: score every item %8.2f ms, score the candidates %6.2f ms\n",
+            query.c_str(), matches.size(), fuzzyScored, everyItem, candidates);
+        CHECK(actual.size() == expected.size());
+        // substring matches outrank fuzzy ones, so those are the same either way
+        for (size_t i = 0; i < actual.size() && i < matches.size(); i++) {
+            CHECK(actual[i] == expected[i]);
+        }
+    }
+    return TEST_RESULT();
+}
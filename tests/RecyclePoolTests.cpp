@@ -0,0 +1,148 @@
+#include "test.h"
+#include <cppxaml/RecyclePool.h>
+#include <memory>
+#include <string>
+
+namespace {
+    // Stands in for a XAML element: it has a type, some state that reset clears, and may still be in a tree.
+    struct FakeElement {
+        std::string type;
+        int id{};
+        std::string text;
+        bool inTree{ false };
+    };
+
+    struct FakeTraits {
+        using element_t = std::shared_ptr<FakeElement>;
+        using type_key_t = std::string;
+
+        static bool reset(element_t& element) {
+            if (element->inTree) return false;
+            element->text.clear();
+            return true;
+        }
+    };
+
+    using Pool = cppxaml::templates::RecyclePool<FakeTraits>;
+
+    // Creates new elements, and counts them.
+    struct FakeFactory {
+        int created{ 0 };
+
+        auto For(std::string type) {
+            return [this, type] { return std::make_shared<FakeElement>(FakeElement{ type, ++created, {}, false }); };
+        }
+    };
+
+    void TestHitsAndMisses() {
+        Pool pool(10);
+        FakeFactory factory;
+        const Pool::Key button{ "Button" };
+
+        auto first = pool.Acquire(button, factory.For("Button"));
+        CHECK(factory.created == 1 && pool.Stats().misses == 1 && pool.Stats().hits == 0);
+        first->text = "OK";
+        const auto id = first->id;
+        CHECK(pool.Release(button, first));
+        CHECK(pool.size() == 1 && pool.size(button) == 1 && pool.Stats().recycled == 1);
+
+        // the released element comes back, reset, without creating a new one
+        auto second = pool.Acquire(button, factory.For("Button"));
+        CHECK(second->id == id && second->text.empty());
+        CHECK(factory.created == 1 && pool.Stats().hits == 1 && pool.Stats().misses == 1);
+        CHECK(pool.size() == 0);
+
+        // the pool is empty again
+        auto third = pool.Acquire(button, factory.For("Button"));
+        CHECK(third->id != id && factory.created == 2 && pool.Stats().misses == 2);
+    }
+
+    void TestKeys() {
+        Pool pool(10);
+        FakeFactory factory;
+        const Pool::Key button{ "Button" }, textBlock{ "TextBlock" }, buttonFromTemplate{ "Button", 7 }, buttonFromOtherTemplate{ "Button", 8 };
+
+        CHECK(pool.Release(button, pool.Acquire(button, factory.For("Button"))));
+        CHECK(pool.Release(buttonFromTemplate, pool.Acquire(buttonFromTemplate, factory.For("Button"))));
+        CHECK(factory.created == 2);
+
+        // another type, or the same type from another template, doesn't get those
+        auto element = pool.Acquire(textBlock, factory.For("TextBlock"));
+        CHECK(element->type == "TextBlock" && factory.created == 3);
+        element = pool.Acquire(buttonFromOtherTemplate, factory.For("Button"));
+        CHECK(element->id == 4 && factory.created == 4);
+
+        // each key gets its own back
+        element = pool.Acquire(buttonFromTemplate, factory.For("Button"));
+        CHECK(element->id == 2);
+        element = pool.Acquire(button, factory.For("Button"));
+        CHECK(element->id == 1);
+        CHECK(factory.created == 4 && pool.Stats().hits == 2 && pool.Stats().misses == 4);
+    }
+
+    void TestCapacity() {
+        Pool pool(3);
+        FakeFactory factory;
+        const Pool::Key button{ "Button" }, textBlock{ "TextBlock" };
+
+        CHECK(pool.Release(button, factory.For("Button")()));
+        CHECK(pool.Release(textBlock, factory.For("TextBlock")()));
+        CHECK(pool.Release(button, factory.For("Button")()));
+        // the fourth release finds the pool full
+        CHECK(!pool.Release(textBlock, factory.For("TextBlock")()));
+        CHECK(pool.size() == 3 && pool.size(button) == 2 && pool.size(textBlock) == 1);
+        CHECK(pool.Stats().recycled == 3 && pool.Stats().rejected == 1);
+
+        // lowering the capacity evicts elements, from every key
+        pool.Capacity(1);
+        CHECK(pool.Capacity() == 1 && pool.size() == 1 && pool.Stats().evicted == 2);
+        CHECK(pool.size(button) + pool.size(textBlock) == 1);
+        CHECK(!pool.Release(button, factory.For("Button")()));
+
+        pool.Capacity(0);
+        CHECK(pool.size() == 0 && pool.Stats().evicted == 3);
+        CHECK(!pool.Release(button, factory.For("Button")()));
+
+        pool.Capacity(5);
+        CHECK(pool.Release(button, factory.For("Button")()));
+        CHECK(pool.Release(button, factory.For("Button")()));
+        pool.Clear();
+        CHECK(pool.size() == 0 && pool.size(button) == 0 && pool.Stats().evicted == 5);
+    }
+
+    void TestRejectedByReset() {
+        Pool pool(10);
+        FakeFactory factory;
+        const Pool::Key button{ "Button" };
+
+        auto element = pool.Acquire(button, factory.For("Button"));
+        element->inTree = true;
+        element->text = "still shown";
+        CHECK(!pool.Release(button, element));
+        CHECK(pool.size() == 0 && pool.Stats().rejected == 1 && pool.Stats().recycled == 0);
+        // it isn't handed out again
+        CHECK(pool.Acquire(button, factory.For("Button")) != element);
+        CHECK(factory.created == 2);
+    }
+
+    void TestCustomReset() {
+        int resets = 0;
+        Pool pool(10, [&resets](FakeTraits::element_t& element) {
+            resets++;
+            return element->type != "Popup";
+        });
+        FakeFactory factory;
+        CHECK(pool.Release({ "Button" }, factory.For("Button")()));
+        CHECK(!pool.Release({ "Popup" }, factory.For("Popup")()));
+        CHECK(resets == 2 && pool.size() == 1);
+    }
+}
+
+int main() {
+    TestHitsAndMisses();
+    TestKeys();
+    TestCapacity();
+    TestRejectedByReset();
+    TestCustomReset();
+    return TEST_RESULT();
+}
@@ -0,0 +1,125 @@
+#include "test.h"
+#include <cppxaml/SearchHandler.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    // Stands in for an AutoSuggestBox: a handle to shared state, with an attached property for the handler and a TextChanged event.
+    struct FakeSearchBox {
+        struct State {
+            std::wstring text;
+            std::shared_ptr<cppxaml::search::SearchHandler<FakeSearchBox>> handler;
+            std::vector<std::function<void(const FakeSearchBox&)>> textChanged;
+        };
+        std::shared_ptr<State> state = std::make_shared<State>();
+
+        // what the user typing a character does
+        void Type(wchar_t c) const {
+            state->text.push_back(c);
+            for (const auto& handler : state->textChanged) {
+                handler(*this);
+            }
+        }
+    };
+
+    struct FakeTraits {
+        using control_t = FakeSearchBox;
+        using handler_ptr = std::shared_ptr<cppxaml::search::SearchHandler<FakeSearchBox>>;
+
+        static handler_ptr get(const control_t& box) { return box.state->handler; }
+
+        static handler_ptr create(const control_t& box) {
+            box.state->handler = std::make_shared<cppxaml::search::SearchHandler<FakeSearchBox>>();
+            return box.state->handler;
+        }
+
+        template<typename F>
+        static void subscribe(const control_t& box, F onUserInput) {
+            box.state->textChanged.push_back(onUserInput);
+        }
+    };
+
+    using Handler = cppxaml::search::AttachedSearchHandler<FakeTraits>;
+
+    // Sets up search the way the AutoSuggestBox wrapper does: copies and moves share the control, and enabling search goes through the attached handler.
+    struct FakeWrapper {
+        FakeSearchBox box;
+        std::shared_ptr<std::vector<std::wstring>> searches = std::make_shared<std::vector<std::wstring>>();
+
+        FakeWrapper& EnableSearch(std::wstring tag = L"") {
+            Handler::Attach(box)->Set([searches = searches, tag](const FakeSearchBox& sender) {
+                searches->push_back(tag + sender.state->text);
+                });
+            return *this;
+        }
+    };
+
+    void TestCopiesAndMoves() {
+        FakeWrapper original;
+        original.EnableSearch();
+        std::vector<FakeWrapper> copies;
+        for (int i = 0; i < 50; i++) {
+            copies.push_back(original);
+            // some copies enable search again, as passing a wrapper through builders does
+            if (i % 3 == 0) {
+                copies.back().EnableSearch();
+            }
+        }
+        std::vector<FakeWrapper> moved;
+        for (auto& copy : copies) {
+            moved.push_back(std::move(copy));
+        }
+        copies.clear();
+        auto last = std::move(moved.back());
+        moved.clear();
+
+        last.box.Type(L'a');
+        CHECK(Handler::Get(last.box)->Invocations() == 1);
+        CHECK(original.box.state->textChanged.size() == 1);
+        CHECK(original.searches->size() == 1 && original.searches->front() == L"a");
+        last.box.Type(L'b');
+        CHECK(Handler::Get(original.box)->Invocations() == 2);
+        CHECK(original.searches->size() == 2 && original.searches->back() == L"ab");
+    }
+
+    void TestEnablingAgainReplacesTheSearch() {
+        FakeWrapper wrapper;
+        wrapper.EnableSearch(L"first:");
+        auto copy = wrapper;
+        copy.EnableSearch(L"second:");
+        wrapper.box.Type(L'x');
+        CHECK(*wrapper.searches == std::vector<std::wstring>{ L"second:x" });
+        CHECK(Handler::Get(wrapper.box)->Invocations() == 1);
+    }
+
+    void TestBoxesAreIndependent() {
+        FakeWrapper a, b;
+        CHECK(!Handler::Get(a.box));
+        a.EnableSearch();
+        CHECK(Handler::Get(a.box) && !Handler::Get(b.box));
+        b.EnableSearch();
+        a.box.Type(L'1');
+        a.box.Type(L'2');
+        b.box.Type(L'3');
+        CHECK(Handler::Get(a.box)->Invocations() == 2 && Handler::Get(b.box)->Invocations() == 1);
+        CHECK(a.searches->size() == 2 && b.searches->size() == 1);
+    }
+
+    void TestNoSearchSet() {
+        FakeSearchBox box;
+        Handler::Attach(box);
+        box.Type(L'a');
+        CHECK(Handler::Get(box)->Invocations() == 1);
+    }
+}
+
+int main() {
+    TestCopiesAndMoves();
+    TestEnablingAgainReplacesTheSearch();
+    TestBoxesAreIndependent();
+    TestNoSearchSet();
+    return TEST_RESULT();
+}
@@ -0,0 +1,226 @@
+#include "test.h"
+#include <cppxaml/Search.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace cppxaml::search;
+namespace search = cppxaml::search;
+
+namespace {
+    std::vector<std::wstring> RandomItems(std::mt19937& rng, size_t count, size_t maxLength, const wchar_t* alphabet) {
+        const std::wstring_view letters(alphabet);
+        std::uniform_int_distribution<size_t> length(0, maxLength);
+        std::uniform_int_distribution<size_t> letter(0, letters.size() - 1);
+        std::vector<std::wstring> items(count);
+        for (auto& item : items) {
+            item.resize(length(rng));
+            for (auto& c : item) {
+                c = letters[letter(rng)];
+            }
+        }
+        return items;
+    }
+
+    std::wstring Lower(std::wstring_view s) {
+        std::wstring out(s);
+        for (auto& c : out) {
+            c = fold(c);
+        }
+        return out;
+    }
+
+    std::vector<id_t> FindLinear(const std::vector<std::wstring>& items, std::wstring_view query, bool caseInsensitive) {
+        std::vector<id_t> ids;
+        const auto needle = caseInsensitive ? Lower(query) : std::wstring(query);
+        for (id_t id = 0; id < items.size(); id++) {
+            const auto haystack = caseInsensitive ? Lower(items[id]) : items[id];
+            if (haystack.find(needle) != std::wstring::npos) {
+                ids.push_back(id);
+            }
+        }
+        return ids;
+    }
+
+    void TestFind() {
+        std::mt19937 rng(1);
+        for (const bool caseInsensitive : { false, true }) {
+            for (int i = 0; i < 20000; i++) {
+                const auto pair = RandomItems(rng, 2, 40, L"abAB\u00e9");
+                const auto expected = caseInsensitive ? Lower(pair[0]).find(Lower(pair[1])) : pair[0].find(pair[1]);
+                CHECK(search::find(pair[0], pair[1], caseInsensitive) == (expected == std::wstring::npos ? std::wstring_view::npos : expected));
+            }
+        }
+        CHECK(search::find(L"Hello", L"") == 0);
+        CHECK(search::find(L"", L"a") == std::wstring_view::npos);
+        CHECK(search::contains(L"Times New Roman", L"new ROMAN", true));
+        CHECK(!search::contains(L"Times New Roman", L"new ROMAN", false));
+        CHECK(search::equals(L"Arial", L"aRIAL", true));
+    }
+
+    void TestSubstringIndex() {
+        std::mt19937 rng(2);
+        for (const bool caseInsensitive : { false, true }) {
+            const auto items = RandomItems(rng, 500, 12, L"abcABC ");
+            const SubstringIndex index(items, caseInsensitive);
+            CHECK(index.size() == items.size());
+            // single characters take the scanning path, longer queries the suffix arrays
+            for (const auto* query : { L"a", L"B", L" ", L"ab", L"aBc", L"c a", L"cccc", L"z" }) {
+                CHECK(index.Find(query) == FindLinear(items, query, caseInsensitive));
+            }
+            CHECK(index.Find(L"").size() == items.size());
+        }
+    }
+
+    void TestAppend() {
+        std::mt19937 rng(3);
+        const auto first = RandomItems(rng, 200, 10, L"abcd");
+        const auto second = RandomItems(rng, 300, 10, L"abcdABCD");
+        auto all = first;
+        all.insert(all.end(), second.begin(), second.end());
+
+        const auto base = std::make_shared<const SubstringIndex>(first, true);
+        const auto appended = base->Append(second);
+        CHECK(base->size() == first.size());
+        CHECK(appended->size() == all.size());
+        for (id_t id = 0; id < all.size(); id++) {
+            CHECK(appended->Items().Item(id) == all[id]);
+        }
+        for (const auto* query : { L"a", L"ab", L"Dc", L"abcd" }) {
+            CHECK(appended->Find(query) == FindLinear(all, query, true));
+            CHECK(base->Find(query) == FindLinear(first, query, true));
+        }
+    }
+
+    void TestAppendChunks() {
+        std::mt19937 rng(5);
+        for (const bool caseInsensitive : { false, true }) {
+            std::vector<std::wstring> all;
+            auto index = std::make_shared<const SubstringIndex>(std::vector<std::wstring>{}, caseInsensitive);
+            std::vector<std::shared_ptr<const SubstringIndex>> snapshots;
+            for (int chunk = 0; chunk < 50; chunk++) {
+                // folding only starts to matter part way through
+                const auto items = RandomItems(rng, chunk % 7, 8, chunk < 20 ? L"abc" : L"abcABC");
+                all.insert(all.end(), items.begin(), items.end());
+                index = index->Append(items);
+                snapshots.push_back(index);
+            }
+            CHECK(index->size() == all.size());
+            for (id_t id = 0; id < all.size(); id++) {
+                CHECK(index->Items().Item(id) == all[id]);
+            }
+            CHECK(index->Find(L"aB") == FindLinear(all, L"aB", caseInsensitive));
+
+            // appending to an older snapshot must not overwrite the items appended after it
+            const auto& older = snapshots[30];
+            const std::vector<std::wstring> branch{ L"xyz", L"Xy" };
+            const auto branched = older->Append(branch);
+            CHECK(branched->size() == older->size() + branch.size());
+            CHECK(branched->Items().Item(static_cast<id_t>(older->size())) == L"xyz");
+            CHECK(branched->Find(L"xy").size() == (caseInsensitive ? 2 : 1));
+            CHECK(index->Find(L"xy").empty());
+            for (id_t id = 0; id < all.size(); id++) {
+                CHECK(index->Items().Item(id) == all[id]);
+            }
+            for (const auto& snapshot : snapshots) {
+                for (id_t id = 0; id < snapshot->size(); id++) {
+                    CHECK(snapshot->Items().Item(id) == all[id]);
+                }
+            }
+        }
+    }
+
+    void TestIncrementalSearch() {
+        std::mt19937 rng(4);
+        const auto items = RandomItems(rng, 1000, 12, L"abc");
+        auto index = std::make_shared<const SubstringIndex>(items, true);
+        IncrementalSearch incremental(index);
+        for (const auto* query : { L"a", L"ab", L"abc", L"ab", L"b", L"bca" }) {
+            CHECK(incremental.FindFolded(query) == FindLinear(items, query, true));
+        }
+    }
+
+    void TestDiff() {
+        std::mt19937 rng(5);
+        for (int i = 0; i < 200; i++) {
+            std::vector<id_t> from, to;
+            for (id_t id = 0; id < 50; id++) {
+                if (rng() % 2) from.push_back(id);
+                if (rng() % 2) to.push_back(id);
+            }
+            if (i % 2) {
+                std::shuffle(to.begin(), to.end(), rng);
+            }
+            auto list = from;
+            for (const auto& edit : Diff(from, to)) {
+                if (edit.kind == Edit::Kind::Remove) {
+                    CHECK(list[edit.index] == edit.id);
+                    list.erase(list.begin() + edit.index);
+                }
+                else {
+                    list.insert(list.begin() + edit.index, edit.id);
+                }
+            }
+            CHECK(list == to);
+        }
+    }
+
+    void TestRank() {
+        const std::vector<std::wstring> items{ L"Arial", L"Times New Roman", L"Segoe UI", L"Courier New", L"New York" };
+        const SubstringIndex index(items, true);
+        const auto ranked = index.FindRanked(L"new", 0);
+        CHECK(ranked.size() == 3);
+        CHECK(ranked.front() == 4); // a prefix match beats word matches
+        const auto fuzzy = index.FindRanked(L"tnr", 0);
+        CHECK(fuzzy.size() == 1 && fuzzy.front() == 1);
+    }
+
+    // Ranks by scoring every item, which is what the fuzzy candidates must be equivalent to when they fit in the budget.
+    std::vector<id_t> RankEveryItem(const SubstringIndex& index, std::wstring_view query, size_t maxResults) {
+        std::vector<id_t> all(index.size());
+        for (id_t id = 0; id < all.size(); id++) {
+            all[id] = id;
+        }
+        const auto folded = index.Fold(query);
+        return search::Rank(index.Items(), folded, index.FindFolded(folded), all, maxResults);
+    }
+
+    void TestFuzzyCandidates() {
+        std::mt19937 rng(7);
+        const SubstringIndex index(RandomItems(rng, 2000, 12, L"abcdeFGhijxyz "), true);
+        const SubstringIndex appended = *SubstringIndex(RandomItems(rng, 1000, 12, L"abcdeFGhijxyz "), true).Append(RandomItems(rng, 1000, 12, L"abcdeFGhijxyz "));
+        for (const auto* searched : { &index, &appended }) {
+            for (const std::wstring query : { L"a", L"fg", L"axz", L"jihg", L"x y", L"zzzz", L"q" }) {
+                for (size_t maxResults : { size_t{ 0 }, size_t{ 5 }, size_t{ 50 } }) {
+                    CHECK(searched->FindRanked(query, maxResults, searched->size() * 12) == RankEveryItem(*searched, query, maxResults));
+                }
+                // every fuzzy match contains each character of the query
+                const auto candidates = searched->FuzzyCandidates(searched->Fold(query), searched->size() * 12);
+                CHECK(std::is_sorted(candidates.begin(), candidates.end()));
+                for (id_t id = 0; id < searched->size(); id++) {
+                    const auto folded = searched->Items().Folded(id);
+                    const bool hasAll = std::all_of(query.begin(), query.end(), [&](wchar_t c) { return folded.find(search::fold(c)) != std::wstring_view::npos; });
+                    CHECK(!hasAll || std::binary_search(candidates.begin(), candidates.end(), id));
+                }
+            }
+        }
+
+        // the budget bounds the number of candidates
+        CHECK(index.FuzzyCandidates(L"a", 10).size() <= 10);
+        CHECK(index.FindRanked(L"axz", 0, 10).size() <= index.FindFolded(L"axz").size() + 10);
+        CHECK(index.FuzzyCandidates(L"", 10).empty());
+    }
+}
+
+int main() {
+    TestFind();
+    TestSubstringIndex();
+    TestAppend();
+    TestAppendChunks();
+    TestIncrementalSearch();
+    TestDiff();
+    TestRank();
+    TestFuzzyCandidates();
+    return TEST_RESULT();
+}
@@ -0,0 +1,49 @@
+// Maps 1M elements with cppxaml::utils::transform, sequentially and with std::execution::par.
+#include "test.h"
+#include <cppxaml/Parallel.h>
+#include <cmath>
+#include <cstdio>
+#include <execution>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Reading {
+        double value;
+        int sensor;
+    };
+
+    // the kind of work a view-model does per element: some arithmetic and formatting
+    std::wstring Describe(const Reading& r) {
+        const auto smoothed = std::sqrt(std::abs(r.value)) * std::log1p(std::abs(r.value));
+        return L"Sensor " + std::to_wstring(r.sensor) + L": " + std::to_wstring(smoothed);
+    }
+}
+
+int main() {
+    constexpr size_t count = 1000000;
+    std::vector<Reading> readings(count);
+    for (size_t i = 0; i < count; i++) {
+        readings[i] = { static_cast<double>(i) * 0.37 - 1000, static_cast<int>(i % 128) };
+    }
+
+    std::vector<std::wstring> sequential;
+    std::vector<std::wstring> parallel;
+    const auto sequentialMs = cppxaml_tests::MeasureMs([&] { sequential = cppxaml::utils::transform(readings, Describe); }, 3);
+    const auto parallelMs = cppxaml_tests::MeasureMs([&] { parallel = cppxaml::utils::transform(std::execution::par, readings, Describe); }, 3);
+    CHECK(parallel == sequential);
+
+    std::vector<std::wstring> indexed;
+    cppxaml_tests::MeasureMs([&] {
+        indexed = cppxaml::utils::transform_with_index(std::execution::par, readings, [](const Reading& r, auto index) {
+            return std::to_wstring(index) + L" " + Describe(r);
+        });
+    }, 1);
+    CHECK(indexed.size() == count);
+    CHECK(indexed[count - 1] == std::to_wstring(count - 1) + L" " + sequential[count - 1]);
+
+    std::printf("%zu elements, %u hardware threads: sequential %.1f ms, std::execution::par %.1f ms (%.2fx)\n",
+        count, std::thread::hardware_concurrency(), sequentialMs, parallelMs, sequentialMs / parallelMs);
+    return TEST_RESULT();
+}
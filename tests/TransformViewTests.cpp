@@ -0,0 +1,226 @@
+#include "test.h"
+#include <cppxaml/utils.h>
+#include <forward_list>
+#include <list>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+    // Stands in for a XAML element.
+    struct FakeElement {
+        std::wstring text;
+    };
+
+    // Stands in for cppxaml::details::UIElementInGrid.
+    struct FakeElementInGrid {
+        int row;
+        int column;
+        FakeElement element;
+    };
+
+    struct FakePanel {
+        std::vector<FakeElement> children;
+        size_t reserved{};
+    };
+
+    struct FakeGrid {
+        std::vector<FakeElementInGrid> children;
+        size_t reserved{};
+    };
+
+    // Consumes a range the way cppxaml::MakePanel does: reserve when the size is known, then a single pass with auto&&.
+    template<typename TElements>
+    FakePanel MakeFakePanel(TElements&& elems) {
+        FakePanel panel;
+        cppxaml::details::reserve_for(panel.children, elems);
+        panel.reserved = panel.children.capacity();
+        for (auto&& e : elems) {
+            panel.children.push_back(e);
+        }
+        return panel;
+    }
+
+    // Consumes a range the way cppxaml::Grid does: entries are either placed elements, or plain elements that go in cell 0, 0.
+    template<typename TElements>
+    FakeGrid MakeFakeGrid(TElements&& elems) {
+        FakeGrid grid;
+        cppxaml::details::reserve_for(grid.children, elems);
+        grid.reserved = grid.children.capacity();
+        for (auto&& e : elems) {
+            if constexpr (std::is_assignable_v<FakeElementInGrid&, decltype(e)>) {
+                grid.children.push_back(e);
+            }
+            else {
+                grid.children.push_back(FakeElementInGrid{ 0, 0, e });
+            }
+        }
+        return grid;
+    }
+
+    void TestOrder() {
+        const std::vector<int> numbers{ 3, 1, 2 };
+        int calls = 0;
+        auto view = cppxaml::utils::transform_view(numbers, [&](int n) { calls++; return n * 10; });
+        // nothing gets mapped until the view is iterated
+        CHECK(calls == 0);
+        CHECK(view.size() == 3);
+
+        std::vector<int> mapped;
+        for (auto&& n : view) {
+            mapped.push_back(n);
+        }
+        CHECK((mapped == std::vector<int>{ 30, 10, 20 }));
+        CHECK(calls == 3);
+
+        // each iteration maps again
+        mapped.clear();
+        for (auto it = view.begin(); it != view.end(); it++) {
+            mapped.push_back(*it);
+        }
+        CHECK((mapped == std::vector<int>{ 30, 10, 20 }));
+        CHECK(calls == 6);
+
+        // ranges without random access work too
+        const std::list<std::wstring> words{ L"b", L"a", L"c" };
+        std::wstring joined;
+        for (auto&& w : cppxaml::utils::transform_view(words, [](const std::wstring& s) { return s + L"!"; })) {
+            joined += w;
+        }
+        CHECK(joined == L"b!a!c!");
+    }
+
+    void TestEnumerate() {
+        const std::vector<std::wstring> words{ L"first", L"second", L"third" };
+        auto view = cppxaml::utils::enumerate(words);
+        CHECK(view.size() == 3);
+
+        size_t expected = 0;
+        for (auto [index, value] : view) {
+            CHECK(index == expected);
+            // the values reference the range rather than copying it
+            CHECK(&value == &words[index]);
+            expected++;
+        }
+        CHECK(expected == 3);
+
+        // the index counts iterations, so it doesn't need random access iterators
+        const std::list<int> numbers{ 7, 8, 9 };
+        expected = 0;
+        for (const auto& e : cppxaml::utils::enumerate(numbers)) {
+            CHECK(e.index == expected);
+            CHECK(e.value == static_cast<int>(7 + expected));
+            expected++;
+        }
+        CHECK(expected == 3);
+
+        // post-increment yields the old position
+        auto it = view.begin();
+        auto old = it++;
+        CHECK((*old).index == 0);
+        CHECK((*it).index == 1);
+        CHECK((*it).value == L"second");
+    }
+
+    void TestEmpty() {
+        const std::vector<int> none;
+        int calls = 0;
+        auto view = cppxaml::utils::transform_view(none, [&](int n) { calls++; return n; });
+        CHECK(view.size() == 0);
+        CHECK(view.begin() == view.end());
+        for (auto&& n : view) {
+            (void)n;
+            CHECK(false);
+        }
+        CHECK(calls == 0);
+
+        auto enumerated = cppxaml::utils::enumerate(none);
+        CHECK(enumerated.size() == 0);
+        CHECK(enumerated.begin() == enumerated.end());
+
+        auto panel = MakeFakePanel(cppxaml::utils::transform_view(std::vector<std::wstring>{}, [](const std::wstring& s) { return FakeElement{ s }; }));
+        CHECK(panel.children.empty());
+        auto grid = MakeFakeGrid(cppxaml::utils::transform_view(cppxaml::utils::enumerate(std::vector<std::wstring>{}), [](const auto& e) {
+            return FakeElementInGrid{ static_cast<int>(e.index), 0, FakeElement{ e.value } };
+        }));
+        CHECK(grid.children.empty());
+    }
+
+    void TestStorage() {
+        // an lvalue is referenced, so the view sees later changes to it
+        std::vector<int> numbers{ 1, 2 };
+        auto referencing = cppxaml::utils::transform_view(numbers, [](int n) { return n + 1; });
+        numbers.push_back(3);
+        CHECK(referencing.size() == 3);
+        int sum = 0;
+        for (auto&& n : referencing) sum += n;
+        CHECK(sum == 9);
+
+        // an rvalue is owned by the view, so it outlives the temporary
+        auto owning = cppxaml::utils::transform_view(std::vector<int>{ 4, 5, 6 }, [](int n) { return n * 2; });
+        sum = 0;
+        for (auto&& n : owning) sum += n;
+        CHECK(sum == 30);
+
+        auto enumerated = cppxaml::utils::enumerate(std::vector<std::wstring>{ L"x", L"y" });
+        std::wstring joined;
+        for (auto [index, value] : enumerated) {
+            joined += std::to_wstring(index) + value;
+        }
+        CHECK(joined == L"0x1y");
+
+        // size() is only there when the underlying range has one, so builders only reserve when they can
+        const std::forward_list<int> unsized{ 1, 2, 3 };
+        auto unsizedView = cppxaml::utils::transform_view(unsized, [](int n) { return n; });
+        static_assert(!cppxaml::details::has_size<decltype(unsizedView)>::value);
+        static_assert(cppxaml::details::has_size<decltype(referencing)>::value);
+        static_assert(!cppxaml::details::has_size<decltype(cppxaml::utils::enumerate(unsized))>::value);
+        auto panel = MakeFakePanel(cppxaml::utils::transform_view(unsized, [](int n) { return FakeElement{ std::to_wstring(n) }; }));
+        CHECK(panel.reserved == 0);
+        CHECK(panel.children.size() == 3);
+    }
+
+    void TestBuilders() {
+        const std::vector<std::wstring> strs{ L"first", L"second", L"third", L"fourth" };
+
+        int calls = 0;
+        auto panel = MakeFakePanel(cppxaml::utils::transform_view(strs, [&](const std::wstring& t) {
+            calls++;
+            return FakeElement{ t };
+        }));
+        CHECK(calls == 4);
+        CHECK(panel.reserved == 4);
+        CHECK(panel.children.size() == 4);
+        for (size_t i = 0; i < strs.size(); i++) {
+            CHECK(panel.children[i].text == strs[i]);
+        }
+
+        // the lazy counterpart of the transform_with_index example in utils.h
+        auto grid = MakeFakeGrid(cppxaml::utils::transform_view(cppxaml::utils::enumerate(strs), [](const auto& e) {
+            auto& [index, t] = e;
+            return FakeElementInGrid{ static_cast<int>(index) / 2, static_cast<int>(index) % 2, FakeElement{ t } };
+        }));
+        CHECK(grid.reserved == 4);
+        CHECK(grid.children.size() == 4);
+        for (size_t i = 0; i < strs.size(); i++) {
+            CHECK(grid.children[i].row == static_cast<int>(i) / 2);
+            CHECK(grid.children[i].column == static_cast<int>(i) % 2);
+            CHECK(grid.children[i].element.text == strs[i]);
+        }
+
+        // plain elements go through the other branch
+        auto plain = MakeFakeGrid(cppxaml::utils::transform_view(strs, [](const std::wstring& t) { return FakeElement{ t }; }));
+        CHECK(plain.children.size() == 4);
+        CHECK(plain.children[3].row == 0);
+        CHECK(plain.children[3].element.text == L"fourth");
+    }
+}
+
+int main() {
+    TestOrder();
+    TestEnumerate();
+    TestEmpty();
+    TestStorage();
+    TestBuilders();
+    return TEST_RESULT();
+}
@@ -0,0 +1,107 @@
+// Built twice: as is, and with CPPXAML_NO_GENERIC_LOOKUP to test find_key's fallback (see tests/CMakeLists.txt).
+#include "test.h"
+#include <cppxaml/utils.h>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <string_view>
+
+namespace {
+    size_t allocations = 0;
+}
+
+// counts heap allocations, to tell whether a lookup built a key
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC sees the free() of memory from operator new, not that both are replaced
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(size_t size) {
+    allocations++;
+    if (auto p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+using namespace cppxaml::utils;
+
+namespace {
+    // longer than any small-string buffer, so that building a std::wstring key allocates
+    constexpr std::wstring_view longKey = L"PointerOverPressedDisabledFocusedUnfocusedSelectedUnselected";
+
+    void TestHash() {
+        const wstring_hash<> exact;
+        const wstring_hash<true> folded;
+        CHECK(exact(L"Normal") == exact(std::wstring(L"Normal")));
+        CHECK(exact(L"Normal") != exact(L"normal"));
+        CHECK(folded(L"Normal") == folded(L"nORMAL"));
+        CHECK(folded(L"PointerOver") == folded(L"pointerover"));
+        CHECK(folded(L"a") != folded(L"b"));
+        // only ASCII letters are folded
+        CHECK(folded(L"\u00c9t\u00e9") != folded(L"\u00e9t\u00e9"));
+        CHECK(folded(L"@[") != folded(L"`{"));
+        CHECK(exact(L"") == folded(L""));
+    }
+
+    void TestEqual() {
+        const wstring_equal<> exact;
+        const wstring_equal<true> folded;
+        CHECK(exact(L"Normal", L"Normal"));
+        CHECK(!exact(L"Normal", L"normal"));
+        CHECK(folded(L"Normal", L"nORMAL"));
+        CHECK(!folded(L"Normal", L"Normals"));
+        CHECK(!folded(L"Normals", L"Normal"));
+        CHECK(!folded(L"\u00c9", L"\u00e9"));
+        CHECK(!folded(L"@", L"`"));
+        CHECK(folded(L"", L""));
+    }
+
+    void TestFindKey() {
+        wstring_map<int> exact{ { L"Normal", 1 }, { L"PointerOver", 2 }, { std::wstring(longKey), 3 } };
+        CHECK(find_key(exact, std::wstring_view(L"PointerOver"))->second == 2);
+        CHECK(find_key(exact, L"Normal")->second == 1);
+        CHECK(find_key(exact, std::wstring(L"Normal"))->second == 1);
+        CHECK(find_key(exact, L"normal") == exact.end());
+        CHECK(find_key(exact, L"Pressed") == exact.end());
+
+        wstring_map<int, true> folded{ { L"Normal", 1 }, { L"PointerOver", 2 }, { std::wstring(longKey), 3 } };
+        CHECK(folded.size() == 3);
+        CHECK(find_key(folded, L"normal")->second == 1);
+        CHECK(find_key(folded, std::wstring_view(L"POINTEROVER"))->second == 2);
+        CHECK(find_key(folded, L"Pressed") == folded.end());
+        // keys that only differ in case are the same key
+        CHECK(!folded.emplace(L"NORMAL", 4).second);
+
+        // const maps work too
+        const auto& constMap = folded;
+        CHECK(find_key(constMap, L"NoRmAl")->second == 1);
+
+        const auto before = allocations;
+        const auto found = find_key(folded, longKey);
+        const auto allocated = allocations - before;
+        CHECK(found != folded.end() && found->second == 3);
+#if defined(__cpp_lib_generic_unordered_lookup) && !defined(CPPXAML_NO_GENERIC_LOOKUP)
+        std::printf("generic lookup: %zu allocations\n", allocated);
+        CHECK(allocated == 0);
+#else
+        // the fallback builds a std::wstring key
+        std::printf("fallback lookup: %zu allocations\n", allocated);
+        CHECK(allocated == 1);
+#endif
+    }
+}
+
+int main() {
+    TestHash();
+    TestEqual();
+    TestFindKey();
+    return TEST_RESULT();
+}
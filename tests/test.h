@@ -0,0 +1,38 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+// A minimal harness: each test is an executable whose exit code is the number of failed checks.
+
+namespace cppxaml_tests {
+    inline int& Failures() {
+        static int failures = 0;
+        return failures;
+    }
+
+    /**
+     * @brief Runs `f` `runs` times, and returns the fastest run in milliseconds.
+    */
+    template<typename F>
+    double MeasureMs(F&& f, int runs = 5) {
+        double best = 1e300;
+        for (int i = 0; i < runs; i++) {
+            const auto start = std::chrono::steady_clock::now();
+            f();
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            best = (std::min)(best, elapsed.count());
+        }
+        return best;
+    }
+}
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::fprintf(stderr, "%s(%d): CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            cppxaml_tests::Failures()++; \
+        } \
+    } while (0)
+
+#define TEST_RESULT() (cppxaml_tests::Failures() == 0 ? 0 : 1)
@@ -0,0 +1,65 @@
+// BuildCatalog: builds a cppxaml suggestion catalog file (see cppxaml/CatalogFile.h) from a UTF-8 text file with one item per line.
+//
+// Usage: BuildCatalog [--case-sensitive] <input.txt> <output.cxsc>
+//
+// Build it with CMake (the tests build it too, see tests/CMakeLists.txt):
+//     cmake -S tools/BuildCatalog -B build/BuildCatalog && cmake --build build/BuildCatalog
+// or with any C++17 compiler, e.g.:
+//     cl /std:c++17 /EHsc /O2 /I..\..\inc BuildCatalog.cpp
+//     g++ -std=c++17 -O2 -I../../inc BuildCatalog.cpp -o BuildCatalog
+
+#include <cppxaml/CatalogFile.h>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+int main(int argc, char** argv) {
+    bool caseInsensitive = true;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg(argv[i]);
+        if (arg == "--case-sensitive") {
+            caseInsensitive = false;
+        }
+        else {
+            paths.emplace_back(arg);
+        }
+    }
+    if (paths.size() != 2) {
+        std::fprintf(stderr, "Usage: BuildCatalog [--case-sensitive] <input.txt> <output.cxsc>\n");
+        return 2;
+    }
+
+    std::ifstream in(paths[0], std::ios::binary);
+    if (!in) {
+        std::fprintf(stderr, "Could not open %s\n", paths[0].c_str());
+        return 1;
+    }
+    std::vector<std::wstring> items;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::string_view item(line);
+        if (items.empty() && item.substr(0, 3) == "\xEF\xBB\xBF") {
+            item.remove_prefix(3);
+        }
+        if (!item.empty() && item.back() == '\r') {
+            item.remove_suffix(1);
+        }
+        if (!item.empty()) {
+            items.push_back(cppxaml::search::details::from_utf8(item));
+        }
+    }
+
+    try {
+        cppxaml::search::WriteCatalogFile(paths[1], cppxaml::search::SubstringIndex(items, caseInsensitive));
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    std::printf("Wrote %zu items to %s\n", items.size(), paths[1].c_str());
+    return 0;
+}